@@ -5,14 +5,43 @@
  */
 #pragma once
 
+#include "apollo/chassis/chassisConfig.hpp"
 #include "apollo/chassis/chassisModel.hpp"
+#include "apollo/chassis/drivetrainGeometry.hpp"
 #include "apollo/chassis/chassisTankModel.hpp"
+#include "apollo/chassis/motorHealthMonitor.hpp"
+#include "apollo/control/driveController.hpp"
+#include "apollo/control/pidController.hpp"
+#include "apollo/gui/fieldMap.hpp"
+#include "apollo/gui/gui.hpp"
+#include "apollo/gui/motorDashboard.hpp"
+#include "apollo/gui/plot.hpp"
+#include "apollo/gui/preflightCheck.hpp"
+#include "apollo/gui/tuningPanel.hpp"
+#include "apollo/gui/widget.hpp"
+#include "apollo/linalg/decomposition.hpp"
+#include "apollo/linalg/matrix.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/telemetry/blackBox.hpp"
+#include "apollo/telemetry/cobs.hpp"
+#include "apollo/telemetry/crc.hpp"
+#include "apollo/telemetry/deltaCodec.hpp"
+#include "apollo/telemetry/ringBuffer.hpp"
+#include "apollo/telemetry/streamFrame.hpp"
+#include "apollo/telemetry/telemetryLogger.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+#include "apollo/telemetry/telemetryStream.hpp"
+#include "apollo/trace/trace.hpp"
+#include "apollo/trace/traceFile.hpp"
+#include "apollo/tuning/parameterConsole.hpp"
+#include "apollo/tuning/parameterRegistry.hpp"
 #include "apollo/units/QAcceleration.hpp"
 #include "apollo/units/QAngle.hpp"
 #include "apollo/units/QAngularAcceleration.hpp"
 #include "apollo/units/QAngularJerk.hpp"
 #include "apollo/units/QAngularSpeed.hpp"
 #include "apollo/units/QArea.hpp"
+#include "apollo/units/QBinaryAngle.hpp"
 #include "apollo/units/QForce.hpp"
 #include "apollo/units/QFrequency.hpp"
 #include "apollo/units/QJerk.hpp"
@@ -24,5 +53,9 @@
 #include "apollo/units/QTorque.hpp"
 #include "apollo/units/QVolume.hpp"
 #include "apollo/units/RQuantity.hpp"
+#include "apollo/units/RQuantityFormat.hpp"
 #include "apollo/units/RQuantityName.hpp"
+#include "apollo/util/bootPipeline.hpp"
+#include "apollo/util/controllerMenu.hpp"
+#include "apollo/util/controllerOutput.hpp"
 #include "apollo/util/util.hpp"
@@ -0,0 +1,191 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+#include "apollo/chassis/drivetrainGeometry.hpp"
+#include "apollo/units/QAcceleration.hpp"
+#include "apollo/units/QAngularAcceleration.hpp"
+#include "apollo/units/QAngularSpeed.hpp"
+#include "apollo/units/QForce.hpp"
+#include "apollo/units/QLength.hpp"
+#include "apollo/units/QMass.hpp"
+#include "apollo/units/QSpeed.hpp"
+#include "apollo/units/QTorque.hpp"
+#include "apollo/util/util.hpp"
+#include "pros/abstract_motor.hpp"
+
+namespace apollo {
+  namespace util {
+    /**
+     * @brief Stall torque at the output shaft of a V5 motor cartridge
+     *
+     * @param input The motor cartridge
+     * @return 2.1, 1.05 or 0.35 Nm, or zero if the cartridge is unknown
+     */
+    constexpr units::QTorque get_cartridge_stall_torque(
+        pros::v5::MotorGears input) {
+      switch(input) {
+        case pros::v5::MotorGears::red:
+          return 2.1 * units::newtonMeter;
+        case pros::v5::MotorGears::green:
+          return 1.05 * units::newtonMeter;
+        case pros::v5::MotorGears::blue:
+          return 0.35 * units::newtonMeter;
+        default:
+          return units::QTorque(0.0);
+      }
+    }
+  }  // namespace util
+
+  /**
+   * @brief Physical description of a drivetrain, in real units.
+   *
+   * Meant to be declared constexpr and checked at compile time, so a wheel
+   * given in millimeters instead of inches fails the build instead of the
+   * autonomous. src/main.cpp has one:
+   *
+   * @code
+   * constexpr DrivetrainConfig drive_config{
+   *     .motor_cartridge = pros::v5::MotorGears::blue,
+   *     .gear_ratio = 48.0 / 36.0,
+   *     .wheel_diameter = 3.25_in,
+   *     .track_width = 11.5_in,
+   *     .motors_per_side = 3,
+   *     .robot_mass = 6_kg};
+   * static_assert(drive_config.is_valid(), "check the drivetrain config");
+   * constexpr units::QSpeed max_speed = drive_config.get_max_linear_speed();
+   * @endcode
+   */
+  struct DrivetrainConfig {
+    /**
+     * @brief Motor Cartridge of your drivetrain motors
+     *
+     */
+    pros::v5::MotorGears motor_cartridge = pros::v5::MotorGears::green;
+    /**
+     * @brief Motor revolutions per wheel revolution (driven teeth / driving
+     * teeth)
+     *
+     */
+    double gear_ratio = 1.0;
+    /**
+     * @brief Diameter of your drivetrain wheels
+     *
+     */
+    units::QLength wheel_diameter = 4 * units::inch;
+    /**
+     * @brief Distance between the centers of the left and right wheels.
+     * Required: zero until set, which fails is_valid().
+     *
+     */
+    units::QLength track_width = units::QLength(0.0);
+    /**
+     * @brief Number of motors powering each side of the drivetrain.
+     * Required: zero until set, which fails is_valid(). The TankModel
+     * constructors taking raw doubles count the left motor ports.
+     *
+     */
+    int motors_per_side = 0;
+    /**
+     * @brief Total mass of the robot. Only used for acceleration limits.
+     * Required: zero until set, which fails is_valid().
+     *
+     */
+    units::QMass robot_mass = units::QMass(0.0);
+
+    /**
+     * @brief Sanity limits that catch unit mix-ups such as a wheel diameter in
+     * millimeters or a gear ratio written upside down
+     *
+     */
+    constexpr bool is_motor_cartridge_valid() const {
+      return util::convert_gear_ratio(motor_cartridge) != INT32_MAX;
+    }
+    constexpr bool is_gear_ratio_valid() const {
+      return gear_ratio >= 0.1 && gear_ratio <= 10.0;
+    }
+    constexpr bool is_wheel_diameter_valid() const {
+      return wheel_diameter >= 1 * units::inch &&
+             wheel_diameter <= 8 * units::inch;
+    }
+    constexpr bool is_track_width_valid() const {
+      return track_width >= 4 * units::inch && track_width <= 36 * units::inch;
+    }
+    constexpr bool is_motors_per_side_valid() const {
+      return motors_per_side >= 1 && motors_per_side <= 4;
+    }
+    constexpr bool is_robot_mass_valid() const {
+      return robot_mass >= 0.5 * units::kg && robot_mass <= 30 * units::kg;
+    }
+    constexpr bool is_valid() const {
+      return is_motor_cartridge_valid() && is_gear_ratio_valid() &&
+             is_wheel_diameter_valid() && is_track_width_valid() &&
+             is_motors_per_side_valid() && is_robot_mass_valid();
+    }
+
+    /**
+     * @brief Tick to distance conversion of the drive motor encoders
+     *
+     * @return DrivetrainGeometry
+     */
+    constexpr DrivetrainGeometry get_geometry() const {
+      return DrivetrainGeometry(motor_cartridge, gear_ratio, wheel_diameter);
+    }
+    /**
+     * @brief Free speed of the drive wheels
+     *
+     * @return units::QAngularSpeed
+     */
+    constexpr units::QAngularSpeed get_wheel_free_speed() const {
+      return (util::convert_gear_ratio(motor_cartridge) * units::rpm) /
+             gear_ratio;
+    }
+    /**
+     * @brief Top speed of the robot driving straight, ignoring friction
+     *
+     * @return units::QSpeed
+     */
+    constexpr units::QSpeed get_max_linear_speed() const {
+      return get_wheel_free_speed() * (wheel_diameter / 2) / units::radian;
+    }
+    /**
+     * @brief Top turning speed of the robot turning in place. Needs
+     * track_width.
+     *
+     * @return units::QAngularSpeed
+     */
+    constexpr units::QAngularSpeed get_max_angular_speed() const {
+      return (2 * get_max_linear_speed() / track_width) * units::radian;
+    }
+    /**
+     * @brief Upper bound on linear acceleration from a standstill, using the
+     * stall torque of every drive motor and ignoring traction. Needs
+     * motors_per_side and robot_mass.
+     *
+     * @return units::QAcceleration
+     */
+    constexpr units::QAcceleration get_max_linear_acceleration() const {
+      return (2 * motors_per_side *
+              util::get_cartridge_stall_torque(motor_cartridge) * gear_ratio /
+              (wheel_diameter / 2)) /
+             robot_mass;
+    }
+    /**
+     * @brief Conservative estimate of angular acceleration turning in place.
+     *
+     * Treats the whole mass as sitting at the wheels, half a track width
+     * from the center. Most robots carry their mass closer in, so their
+     * moment of inertia is smaller and they turn faster than this. That
+     * makes the estimate safe as a motion profile limit, but not an upper
+     * bound. Needs track_width, motors_per_side and robot_mass.
+     *
+     * @return units::QAngularAcceleration
+     */
+    constexpr units::QAngularAcceleration get_max_angular_acceleration()
+        const {
+      return (2 * get_max_linear_acceleration() / track_width) * units::radian;
+    }
+  };
+}  // namespace apollo
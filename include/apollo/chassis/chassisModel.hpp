@@ -4,29 +4,75 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "apollo/chassis/chassisConfig.hpp"
+#include "apollo/chassis/drivetrainGeometry.hpp"
+#include "apollo/telemetry/telemetryLogger.hpp"
 #include "apollo/util/util.hpp"
 #include "pros/misc.h"
 #include "pros/motors.h"
 namespace apollo {
+  enum chassis_device_type {
+    CHASSIS_DEVICE_MOTOR,
+    CHASSIS_DEVICE_IMU,
+    CHASSIS_DEVICE_ROTATION,
+    CHASSIS_DEVICE_ADI_ENCODER
+  };
+
+  /**
+   * @brief A device a chassis was constructed with, kept so the ports can be
+   * checked before a match
+   *
+   */
+  struct chassis_device {
+    chassis_device_type type;
+    /**
+     * @brief Smart port. For ADI encoders, the port of the ADI expander or
+     * INTERNAL_ADI_PORT for the brain's own ADI ports.
+     *
+     */
+    uint8_t port;
+    /**
+     * @brief Top ADI port of an encoder, 1 to 8. 0 for smart devices.
+     *
+     */
+    uint8_t adi_port;
+  };
+
   class ChassisModel {
    public:
+    static constexpr std::size_t MAX_DEVICES = 16;
+
     util::chassis_tracker_type current_tracker_type;
     pros::motor_brake_mode_e_t current_brake_mode = pros::E_MOTOR_BRAKE_COAST;
     pros::motor_encoder_units_e_t current_encoder_units =
         pros::E_MOTOR_ENCODER_ROTATIONS;
-    int joystick_deadband;
-
-    double drivetrain_tick_per_revolution;
-    double drivetrain_tick_per_inch;
+    std::atomic<int> joystick_deadband{0};
 
-    double wheel_motor_cartridge;
-    double wheel_circumference;
-    double wheel_diameter;
-    double wheel_gear_ratio;
-
-    double tracker_circumference;
-    double tracker_diameter;
-    double tracker_gear_ratio;
+    pros::v5::MotorGears wheel_motor_cartridge;
+    /**
+     * @brief Physical description of the drivetrain. Speed and acceleration
+     * limits for motion profiles are derived from it.
+     *
+     */
+    DrivetrainConfig drivetrain_config;
+    /**
+     * @brief Tick to distance conversion of the drive wheels, measured by the
+     * sensored drive motors.
+     *
+     */
+    DrivetrainGeometry drivetrain_geometry;
+    /**
+     * @brief Tick to distance conversion of whichever sensor tracks the
+     * chassis. Identical to drivetrain_geometry when tracking with the drive
+     * motor encoders.
+     *
+     */
+    DrivetrainGeometry tracker_geometry;
 
     void get_chassis_parameters();
 
@@ -35,8 +81,37 @@ namespace apollo {
     void set_encoder_units(pros::motor_encoder_units_e_t encoder_units);
     pros::motor_encoder_units_e_t get_encoder_units();
 
+    /**
+     * @brief Motors, sensors and encoders given to the constructor
+     *
+     */
+    std::size_t get_device_count() const;
+    const chassis_device& get_device(std::size_t index) const;
+
     void set_joystick_deadband(int input);
     int get_joystick_deadband();
+    /**
+     * @brief Sets how strongly joystick readings are curved, clamped to
+     * [0, 1]. 0 is linear and 1 is cubic. Takes effect on the next driver
+     * control tick.
+     *
+     */
+    void set_drive_curve(double curve);
+    double get_drive_curve();
+
+    /**
+     * @brief Sets the multiplier applied to driver control output, clamped to
+     * [0, 1]. Lowered by MotorHealthMonitor as the drive motors heat up.
+     *
+     */
+    void set_driver_output_scale(double scale);
+    double get_driver_output_scale();
+    /**
+     * @brief Clamps a motor command in millivolts to -12000 to 12000 and
+     * applies the driver output scale
+     *
+     */
+    int scale_driver_output(int output);
 
     pros::controller_analog_e_t left_tank_joystick = pros::E_CONTROLLER_ANALOG_LEFT_Y;
     pros::controller_analog_e_t right_tank_joystick = pros::E_CONTROLLER_ANALOG_RIGHT_Y;
@@ -45,6 +120,14 @@ namespace apollo {
     pros::controller_analog_e_t strafe_arcade_joystick;
     pros::controller_analog_e_t rotate_arcade_joystick;
 
+    /**
+     * @brief Reads a joystick and maps it to a drive voltage with
+     * util::drive_voltage(). Control loops that use several sticks read
+     * each once and call util::drive_voltage() themselves, so the whole
+     * tick sees one deadband.
+     *
+     * @return Millivolts, -12000 to 12000, for move_voltage()
+     */
     int get_scaled_voltage(pros::controller_analog_e_t input);
 
     void set_tank_joysticks(pros::controller_analog_e_t left,
@@ -53,5 +136,50 @@ namespace apollo {
                               pros::controller_analog_e_t turn);
     void set_strafe_joysticks(pros::controller_analog_e_t strafe);
     void set_rotate_joysticks(pros::controller_analog_e_t rotate);
+
+    /**
+     * @brief Logs the chassis sensors and commands of every autonomous
+     * control tick to `logger`, for replay with tools/telemetry_replay.
+     * nullptr stops logging.
+     *
+     */
+    void set_telemetry_logger(telemetry::TelemetryLogger* logger);
+
+   protected:
+    /**
+     * @brief Queues `payload` on the telemetry logger, if there is one
+     *
+     */
+    template <typename Payload>
+    void log_telemetry(const Payload& payload) {
+      telemetry::TelemetryLogger* logger =
+          telemetry_logger.load(std::memory_order_relaxed);
+      if(logger != nullptr) {
+        logger->log(payload);
+      }
+    }
+
+    /**
+     * @brief Records a device for get_device(). Nothing is recorded once
+     * MAX_DEVICES devices are.
+     *
+     * @param port Smart port, or for ADI encoders the expander port
+     * @param adi_port ADI encoders only: top port as 1-8 or 'A'-'H',
+     * negative if reversed
+     */
+    void add_device(chassis_device_type type, int port, int adi_port = 0);
+    /**
+     * @brief Records every motor of a motor group
+     *
+     * @param ports Negative if the motor is reversed
+     */
+    void add_motor_devices(const std::vector<int8_t>& ports);
+
+   private:
+    chassis_device devices[MAX_DEVICES];
+    std::size_t device_count = 0;
+    std::atomic<float> driver_output_scale{1.0f};
+    std::atomic<float> drive_curve{0.0f};
+    std::atomic<telemetry::TelemetryLogger*> telemetry_logger{nullptr};
   };
 }  // namespace apollo
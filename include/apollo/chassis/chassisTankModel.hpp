@@ -5,6 +5,9 @@
  */
 #include <vector>
 
+#include "apollo/control/driveController.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/units/QTime.hpp"
 #include "apollo/util/util.hpp"
 #include "chassisModel.hpp"
 #include "pros/adi.hpp"
@@ -70,6 +73,25 @@ namespace apollo {
      *
      */
     pros::Rotation center_rotation_tracker;
+    /**
+     * @brief Controller used by drive_distance(). Tune it through
+     * get_distance_pid() and get_heading_pid().
+     *
+     */
+    DriveController drive_controller{PIDController(600.0, 0.0, 40.0),
+                                      PIDController(300.0, 0.0, 20.0)};
+    /**
+     * @brief Milliseconds between drive_distance() control ticks
+     *
+     */
+    static constexpr uint32_t DRIVE_PERIOD = 10;
+    /**
+     * @brief Pose tracked from the tracking wheels, or the sensored motors
+     * without them, and the Inertial Sensor. It only moves when
+     * update_odometry() or drive_distance() runs.
+     *
+     */
+    Odometry odometry;
     /**
      * @brief Construct a new Tank Drive Drivetrain using Motor Encoders
      *
@@ -89,6 +111,22 @@ namespace apollo {
               std::vector<int8_t> right_motor_ports, int inertial_sensor_port,
               double drivetrain_wheel_diameter, double drivetrain_gear_ratio,
               pros::v5::MotorGears drivetrain_motor_cartridge);
+    /**
+     * @brief Construct a new Tank Drive Drivetrain using Motor Encoders from
+     * a DrivetrainConfig. Prefer this over the raw double constructors, since
+     * the config can be checked with static_assert, and they leave the track
+     * width and robot mass of drivetrain_config unset.
+     *
+     * @param left_motor_ports The ports that the Left Motors are connected to.
+     * The first motor is the sensored motor.
+     * @param right_motor_ports The ports that the Right Motors are connected
+     * to. The first motor is the sensored motor.
+     * @param inertial_sensor_port The Inertial Sensor's port
+     * @param config Physical description of the drivetrain
+     */
+    TankModel(std::vector<int8_t> left_motor_ports,
+              std::vector<int8_t> right_motor_ports, int inertial_sensor_port,
+              const DrivetrainConfig& config);
     /**
      * @brief Construct a new Tank Drive Drivetrain using Left and Right ADI
      * Encoders
@@ -157,5 +195,48 @@ namespace apollo {
               double tracker_gear_ratio);
     void tank_control();
     void arcade_control(bool is_flipped = true, bool is_split = true);
+
+    /**
+     * @brief Drives `distance` while holding the current heading, and
+     * returns once settled within half an inch and a degree or after
+     * `timeout`.
+     *
+     * With a telemetry logger set, every tick is logged as a ChassisRecord
+     * between two DriveTargetRecords, so `tools/telemetry_replay --drive`
+     * can run drive_controller against the log and diff its commands. Each
+     * tick also updates `odometry` and logs it as update_odometry() does.
+     *
+     * @return false if it timed out
+     */
+    bool drive_distance(units::QLength distance,
+                        units::QTime timeout = 3 * units::second);
+    /**
+     * @brief Reads the sensors once and integrates them into `odometry`.
+     * drive_distance() does this every tick; call it from your own loop,
+     * every 10 ms or so, to keep the pose current in between.
+     *
+     * With a telemetry logger set, the chassis, tracking wheel and pose
+     * samples are logged, so `tools/telemetry_replay` can run Odometry
+     * against them.
+     *
+     * @return The new pose
+     */
+    Pose update_odometry();
+
+   private:
+    /**
+     * @brief Reads the tracking wheels, updates `odometry` from them and
+     * `chassis`, and logs the tracker and pose records
+     *
+     */
+    void track_pose(const telemetry::ChassisRecord& chassis);
+    /**
+     * @brief Reads the sensored motors and the Inertial Sensor. Voltages are
+     * left for the caller.
+     *
+     */
+    telemetry::ChassisRecord read_chassis_sensors();
+
+    bool has_center_tracker = false;
   };
 }  // namespace apollo
\ No newline at end of file
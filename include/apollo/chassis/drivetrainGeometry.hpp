@@ -0,0 +1,124 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+#include <cmath>
+
+#include "apollo/units/QLength.hpp"
+#include "apollo/util/util.hpp"
+#include "pros/abstract_motor.hpp"
+
+namespace apollo {
+  /**
+   * @brief Inverse length, used to convert a distance into encoder ticks
+   *
+   */
+  typedef decltype(1.0 / units::meter) QTickDensity;
+
+  /**
+   * @brief Describes how encoder ticks map onto distance travelled by a wheel.
+   *
+   * Everything is computed in the constructor, so a geometry declared
+   * constexpr is folded by the compiler and converting ticks into a distance
+   * costs a single multiply.
+   *
+   * @code
+   * constexpr DrivetrainGeometry drive(pros::v5::MotorGears::blue,
+   *                                    60.0 / 36.0, 3.25_in);
+   * units::QLength travelled = drive.ticks_to_length(motor_position);
+   * @endcode
+   */
+  class DrivetrainGeometry {
+   public:
+    /**
+     * @brief Construct an empty geometry. Every conversion returns zero.
+     *
+     */
+    constexpr DrivetrainGeometry() {}
+    /**
+     * @brief Construct the geometry of a wheel driven by a V5 motor, using
+     * the motor's integrated encoder
+     *
+     * @param motor_cartridge Motor Cartridge of the driving motor
+     * @param gear_ratio Motor revolutions per wheel revolution (driven teeth
+     * / driving teeth)
+     * @param wheel_diameter Diameter of the wheel
+     */
+    constexpr DrivetrainGeometry(pros::v5::MotorGears motor_cartridge,
+                                 double gear_ratio,
+                                 units::QLength wheel_diameter)
+        : DrivetrainGeometry(
+              util::get_cartridge_tick_per_revolution(motor_cartridge),
+              gear_ratio, wheel_diameter) {}
+    /**
+     * @brief Construct the geometry of a wheel measured by an arbitrary
+     * encoder, such as an ADI Encoder or a Rotation Sensor tracking wheel
+     *
+     * @param encoder_tick_per_revolution Ticks per encoder shaft revolution,
+     * see util::ADI_ENCODER_TICK_PER_REVOLUTION and
+     * util::ROTATION_SENSOR_TICK_PER_REVOLUTION
+     * @param gear_ratio Encoder revolutions per wheel revolution (driven
+     * teeth / driving teeth)
+     * @param wheel_diameter Diameter of the wheel
+     */
+    constexpr DrivetrainGeometry(double encoder_tick_per_revolution,
+                                 double gear_ratio,
+                                 units::QLength wheel_diameter)
+        : tick_per_revolution(encoder_tick_per_revolution * gear_ratio),
+          gear_ratio(gear_ratio),
+          wheel_diameter(wheel_diameter),
+          wheel_circumference(wheel_diameter * M_PI),
+          length_per_tick(tick_per_revolution > 0.0
+                              ? wheel_circumference / tick_per_revolution
+                              : units::QLength(0.0)),
+          tick_per_length(wheel_circumference.getValue() > 0.0
+                              ? tick_per_revolution / wheel_circumference
+                              : QTickDensity(0.0)) {}
+
+    /**
+     * @brief Converts an encoder reading into the distance the wheel travelled
+     *
+     * @param ticks Encoder position in ticks
+     * @return units::QLength
+     */
+    constexpr units::QLength ticks_to_length(double ticks) const {
+      return ticks * length_per_tick;
+    }
+    /**
+     * @brief Converts a distance into the encoder reading that produces it
+     *
+     * @param length Distance travelled by the wheel
+     * @return double
+     */
+    constexpr double length_to_ticks(units::QLength length) const {
+      return (length * tick_per_length).getValue();
+    }
+
+    constexpr double get_tick_per_revolution() const {
+      return tick_per_revolution;
+    }
+    constexpr double get_gear_ratio() const { return gear_ratio; }
+    constexpr units::QLength get_wheel_diameter() const {
+      return wheel_diameter;
+    }
+    constexpr units::QLength get_wheel_circumference() const {
+      return wheel_circumference;
+    }
+    constexpr units::QLength get_length_per_tick() const {
+      return length_per_tick;
+    }
+    constexpr QTickDensity get_tick_per_length() const {
+      return tick_per_length;
+    }
+
+   private:
+    double tick_per_revolution = 0.0;
+    double gear_ratio = 0.0;
+    units::QLength wheel_diameter;
+    units::QLength wheel_circumference;
+    units::QLength length_per_tick;
+    QTickDensity tick_per_length;
+  };
+}  // namespace apollo
@@ -0,0 +1,166 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "apollo/chassis/chassisModel.hpp"
+#include "apollo/units/QTime.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  /**
+   * @brief Temperature in degrees Celsius at which V5 motor firmware starts
+   * cutting motor power
+   *
+   */
+  constexpr double MOTOR_THERMAL_LIMIT_TEMPERATURE = 55.0;
+
+  /**
+   * @brief One sample of a drive motor
+   *
+   */
+  struct MotorHealth {
+    /**
+     * @brief Degrees Celsius, reported by the motor in 5 degree steps
+     *
+     */
+    double temperature = 0.0;
+    /**
+     * @brief Milliamps
+     *
+     */
+    int32_t current = 0;
+    /**
+     * @brief Percent of input power turned into output power
+     *
+     */
+    double efficiency = 0.0;
+    bool is_over_temperature = false;
+    bool is_connected = false;
+  };
+
+  /**
+   * @brief Watches drive motor temperatures and backs off driver output
+   * before the motor firmware does.
+   *
+   * The monitor's own low priority task reads every drive motor each
+   * period, four device calls per motor for temperature, current,
+   * efficiency and the over temperature flag, so sampling never runs inside
+   * the control loop. Motors only report temperature in 5 degree steps, so
+   * the heating rate is taken from the time between the hottest motor's last
+   * two steps up, and from it the time until thermal limiting starts.
+   *
+   * Between steps the hottest temperature is estimated from the heating
+   * rate, capped at the next step, and eases back toward the reading when
+   * the next step is overdue. Once the estimate reaches the throttle
+   * temperature, ChassisModel's driver output scale is lowered linearly,
+   * down to the minimum scale at the thermal limit. Ramping on the estimate
+   * spreads the scale change over the time the motor takes to heat through
+   * the last step, instead of dropping from full power to the minimum when
+   * the reading jumps to the limit. A controller warning is shown when
+   * limiting is predicted soon.
+   *
+   * @code
+   * MotorHealthMonitor monitor(chassis, {1, 2, 3, -4, -5, -6});
+   * monitor.start();
+   * @endcode
+   */
+  class MotorHealthMonitor {
+   public:
+    static constexpr std::size_t MAX_MOTORS = 8;
+
+    /**
+     * @brief Construct a new Motor Health Monitor
+     *
+     * @param chassis Chassis whose driver output is scaled
+     * @param motor_ports Drive motor ports. Reversed ports may be negative.
+     * @param period Milliseconds between samples
+     */
+    MotorHealthMonitor(ChassisModel& chassis,
+                       const std::vector<int8_t>& motor_ports,
+                       uint32_t period = 500);
+    ~MotorHealthMonitor();
+
+    void start();
+    void stop();
+
+    /**
+     * @brief Configures throttling of driver output
+     *
+     * @param start_temperature Estimated temperature in degrees Celsius at
+     * which the output starts being scaled down. The reading one step below
+     * the thermal limit, 50 degrees, ramps over the whole last step.
+     * @param minimum_scale Output scale at the thermal limit
+     */
+    void set_throttling(double start_temperature, double minimum_scale);
+    void set_throttling_enabled(bool enabled);
+    /**
+     * @brief Show a warning on the controller and rumble when thermal limiting
+     * is predicted within `horizon`
+     *
+     */
+    void set_warning(bool enabled, units::QTime horizon);
+
+    std::size_t get_motor_count() const;
+    MotorHealth get_motor_health(std::size_t index) const;
+    double get_hottest_temperature() const;
+    /**
+     * @brief Hottest temperature in degrees Celsius estimated from the
+     * heating rate, which throttling is driven by. Rises smoothly between
+     * the 5 degree steps while the motor heats.
+     *
+     */
+    double get_estimated_temperature() const;
+    /**
+     * @brief Predicted time until the hottest motor reaches
+     * MOTOR_THERMAL_LIMIT_TEMPERATURE. Zero if it has, and a negative time if
+     * it is not heating up.
+     *
+     */
+    units::QTime get_time_to_limit() const;
+
+   private:
+    void monitor_loop();
+    void sample();
+    double get_throttle_scale(double temperature) const;
+    void update_warning(double temperature, units::QTime time_to_limit);
+
+    ChassisModel& chassis;
+    int8_t ports[MAX_MOTORS];
+    std::size_t motor_count = 0;
+    uint32_t period;
+    pros::Task* monitor_task = nullptr;
+    std::atomic<bool> running{false};
+
+    std::atomic<double> throttle_temperature{50.0};
+    std::atomic<double> minimum_scale{0.6};
+    std::atomic<bool> throttling_enabled{true};
+    std::atomic<bool> warning_enabled{true};
+    /**
+     * @brief Seconds
+     *
+     */
+    std::atomic<double> warning_horizon{30.0};
+    bool is_warning = false;
+
+    mutable pros::Mutex health_mutex;
+    MotorHealth health[MAX_MOTORS];
+    double hottest_temperature = 0.0;
+    double estimated_temperature = 0.0;
+    double time_to_limit = -1.0;
+
+    // Only touched by the monitor task
+    double last_temperature = 0.0;
+    double last_rise = 0.0;
+    uint32_t last_rise_time = 0;
+    uint32_t previous_rise_time = 0;
+    int rise_count = 0;
+  };
+}  // namespace apollo
@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+#include "apollo/control/pidController.hpp"
+#include "apollo/units/QAngle.hpp"
+#include "apollo/units/QBinaryAngle.hpp"
+#include "apollo/units/QLength.hpp"
+#include "apollo/units/QTime.hpp"
+
+namespace apollo {
+  /**
+   * @brief Drivetrain voltages, in millivolts
+   *
+   */
+  struct DriveOutput {
+    int left_voltage = 0;
+    int right_voltage = 0;
+  };
+
+  /**
+   * @brief Drives a set distance while holding the starting heading, with
+   * one PID controller for distance and one for heading.
+   *
+   * Like Odometry it does not read any devices itself. TankModel feeds it
+   * the same sensor values it logs, so the replay tool reproduces every
+   * command from a telemetry log and can diff a gain change against what
+   * the robot did.
+   */
+  class DriveController {
+   public:
+    /**
+     * @brief Construct a new Drive Controller
+     *
+     * @param distance_pid Millivolts per inch of distance error
+     * @param heading_pid Millivolts per degree of heading error, added to
+     * the left side and taken from the right
+     * @param max_voltage Largest voltage either side is commanded, in
+     * millivolts
+     */
+    DriveController(const PIDController& distance_pid,
+                    const PIDController& heading_pid,
+                    int max_voltage = 12000);
+
+    /**
+     * @brief Starts a new move from the current sensor readings
+     *
+     * @param distance Distance to drive, negative to drive backwards
+     * @param left_distance Distance the left side has travelled so far
+     * @param right_distance Distance the right side has travelled so far
+     * @param heading Heading to hold, clockwise positive like
+     * `imu.get_rotation()`
+     */
+    void start(units::QLength distance, units::QLength left_distance,
+               units::QLength right_distance, units::QAngle heading);
+    /**
+     * @brief Advances both controllers by one tick
+     *
+     * @param time_step Time since the previous step. Pass the loop period
+     * rather than a measured time so replay reproduces the output.
+     */
+    DriveOutput step(units::QLength left_distance,
+                     units::QLength right_distance, units::QAngle heading,
+                     units::QTime time_step);
+    /**
+     * @brief true once the last step was within `distance_tolerance` and
+     * `heading_tolerance` of the target
+     *
+     */
+    bool is_settled(units::QLength distance_tolerance,
+                    units::QAngle heading_tolerance) const;
+
+    PIDController& get_distance_pid();
+    PIDController& get_heading_pid();
+
+   private:
+    PIDController distance_pid;
+    PIDController heading_pid;
+    int max_voltage;
+    units::QLength target_distance = units::QLength(0.0);
+    units::QLength start_left_distance = units::QLength(0.0);
+    units::QLength start_right_distance = units::QLength(0.0);
+    units::BinaryAngle target_heading;
+    units::QLength distance_error = units::QLength(0.0);
+    units::QAngle heading_error = units::QAngle(0.0);
+  };
+}  // namespace apollo
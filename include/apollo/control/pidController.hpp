@@ -0,0 +1,58 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+#include "apollo/units/QTime.hpp"
+
+namespace apollo {
+  /**
+   * @brief Textbook PID controller.
+   *
+   * The time step is passed in rather than read from a clock, so a controller
+   * given the same errors and time steps always produces the same output.
+   * That is what lets the replay tool reproduce a run exactly.
+   */
+  class PIDController {
+   public:
+    /**
+     * @brief Construct a new PID Controller
+     *
+     * @param kP Proportional gain
+     * @param kI Integral gain
+     * @param kD Derivative gain
+     * @param integral_limit Largest magnitude the integral term may reach, in
+     * output units. Zero disables the limit.
+     */
+    PIDController(double kP, double kI, double kD, double integral_limit = 0.0);
+
+    /**
+     * @brief Advances the controller by one tick
+     *
+     * @param error Target minus measurement
+     * @param time_step Time since the previous step
+     * @return The controller output
+     */
+    double step(double error, units::QTime time_step);
+    /**
+     * @brief Clears the integral and derivative history
+     *
+     */
+    void reset();
+
+    void set_gains(double kP, double kI, double kD);
+    double get_kP() const;
+    double get_kI() const;
+    double get_kD() const;
+
+   private:
+    double kP;
+    double kI;
+    double kD;
+    double integral_limit;
+    double integral = 0.0;
+    double previous_error = 0.0;
+    bool has_previous_error = false;
+  };
+}  // namespace apollo
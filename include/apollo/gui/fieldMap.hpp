@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/gui/widget.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/units/QLength.hpp"
+
+namespace apollo {
+  namespace gui {
+    /**
+     * @brief Top-down view of the field with the robot's pose, its planned
+     * path and the trail it left behind.
+     *
+     * The field is drawn into a pixel buffer once, when the map is
+     * constructed. After that a frame blits back only the background under
+     * the robot's previous position and under trail segments that aged out,
+     * redraws path and trail segments crossing those areas, draws the new
+     * trail segments and draws the robot. The rest of the map is untouched.
+     *
+     * Poses are in field coordinates with the origin at the field's center,
+     * x to the right and y up as seen on the screen, and theta
+     * counter-clockwise from the x axis, like Odometry.
+     *
+     * @code
+     * gui::FieldMap map({0, 0, 239, 239});
+     * map.set_path(path_poses, path_length);
+     * // every tick
+     * map.set_pose(odometry.get_pose());
+     * @endcode
+     */
+    class FieldMap : public Widget {
+     public:
+      /**
+       * @brief Trail points shown
+       *
+       */
+      static constexpr std::size_t TRAIL_LENGTH = 128;
+      static constexpr std::size_t MAX_PATH_POINTS = 64;
+
+      /**
+       * @brief Construct a new Field Map. The field is drawn as a square
+       * fitted to the top left of `bounds`.
+       *
+       * @param field_size Width of the square field
+       * @param robot_size Width of the square drawn for the robot
+       */
+      FieldMap(Rect bounds,
+               units::QLength field_size = 144 * units::inch,
+               units::QLength robot_size = 18 * units::inch);
+      ~FieldMap();
+
+      FieldMap(const FieldMap&) = delete;
+      FieldMap& operator=(const FieldMap&) = delete;
+
+      /**
+       * @brief Moves the robot. A trail point is added whenever the robot has
+       * moved TRAIL_SPACING pixels since the last one.
+       *
+       */
+      void set_pose(const Pose& pose);
+      /**
+       * @brief Shows a planned path through the positions of `poses`
+       *
+       * @return false if there are more than MAX_PATH_POINTS poses. The path
+       * is cut to MAX_PATH_POINTS.
+       */
+      bool set_path(const Pose* poses, std::size_t count);
+      void clear_path();
+      void clear_trail();
+
+     protected:
+      void draw(bool is_full_redraw) override;
+
+     private:
+      struct Point {
+        int16_t x;
+        int16_t y;
+      };
+
+      /**
+       * @brief Trail points are stored beyond TRAIL_LENGTH, so the segments
+       * that age out between two draws can still be erased
+       *
+       */
+      static constexpr std::size_t TRAIL_CAPACITY = TRAIL_LENGTH + 32;
+      static constexpr int16_t TRAIL_SPACING = 2;
+
+      Point to_screen(units::QLength x, units::QLength y) const;
+      Rect get_segment_box(Point start, Point end) const;
+      Rect get_robot_box() const;
+      void render_background();
+      void restore(Rect area);
+      void redraw_over(const Rect& area);
+      void draw_trail_segment(uint32_t index);
+      void draw_robot();
+
+      int16_t field_pixels;
+      double pixels_per_meter;
+      int16_t robot_half_size;
+      uint32_t* background_pixels;
+
+      Point path[MAX_PATH_POINTS];
+      std::size_t path_count = 0;
+
+      Point trail[TRAIL_CAPACITY];
+      /**
+       * @brief Trail points added since the last clear. Point n is stored at
+       * n % TRAIL_CAPACITY.
+       *
+       */
+      uint32_t trail_count = 0;
+      uint32_t drawn_trail_count = 0;
+
+      Point robot{0, 0};
+      double robot_theta = 0.0;
+      bool has_pose = false;
+      Rect drawn_robot_box{0, 0, -1, -1};
+    };
+  }  // namespace gui
+}  // namespace apollo
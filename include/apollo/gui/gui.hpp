@@ -1,37 +1,275 @@
-#include "main.h"
-#include "pros/abstract_motor.hpp"
-#include "pros/motors.hpp"
-#include <string>
-#pragma onxw
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/gui/fieldMap.hpp"
+#include "apollo/gui/plot.hpp"
+#include "apollo/gui/widget.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/telemetry/ringBuffer.hpp"
+#include "pros/rtos.hpp"
+
 namespace apollo {
-struct motor {
-  pros::Motor motor;
-  std::string name;
-  int port;
-  pros::MotorGears cartridge;
-  bool is_reversed;
-};
-struct button{
-    int initial_x_postion;
-    int initial_y_postion;
-    int width;
-    int height;
-};
-struct auton {
-  std::string name;
-  std::string description;
-  void autonomous_function();
-};
-class GUI {
-public:
-  // create initializers using drive template params
-  //  add extra motors params
-  bool is_auton_selector_enabled;
-
-private:
-  int total_autons = 0;
-  int selected_auton = 0;
-  int curent_auton_page = 0;
-};
-
-} // namespace apollo
\ No newline at end of file
+  /**
+   * @brief Side of the field the robot starts on, for routines that mirror
+   * their path
+   *
+   */
+  enum field_side { FIELD_SIDE_LEFT, FIELD_SIDE_RIGHT };
+
+  struct auton {
+    const char* name;
+    const char* description;
+    void (*autonomous_function)();
+  };
+
+  /**
+   * @brief Draws the current page of widgets on the brain screen and passes
+   * touches to them.
+   *
+   * Only dirty widgets are drawn. update() stops drawing once the frame
+   * budget is spent and continues with the next dirty widget on the next
+   * call, so a screen full of changes is spread over several ticks instead
+   * of stalling one.
+   *
+   * After start(), the GUI runs in its own low priority task and is the only
+   * task that touches the screen and the widgets. Other tasks, including
+   * autonomous() and opcontrol(), change widgets by posting to a lock-free
+   * queue. A post copies the update into the queue and returns; it never
+   * waits on the GUI task or the display. Posts to a full queue are dropped
+   * and return false.
+   *
+   * @code
+   * gui::Label battery_label({0, 0, 239, 24});
+   * gui::Page status_page;
+   * status_page.add(battery_label);
+   * brain_gui.set_page(status_page);
+   * brain_gui.start();
+   * while(true) {
+   *   brain_gui.post_print(battery_label, "Battery %d%%",
+   *                        (int)pros::battery::get_capacity());
+   *   pros::delay(100);
+   * }
+   * @endcode
+   */
+  class GUI {
+   public:
+    /**
+     * @brief Microseconds of drawing per update
+     *
+     */
+    static constexpr uint32_t DEFAULT_FRAME_BUDGET = 1000;
+    static constexpr std::size_t QUEUE_CAPACITY = 64;
+    static constexpr std::size_t MAX_FRAME_CALLBACKS = 4;
+
+    static constexpr std::size_t MAX_AUTONS = 32;
+    static constexpr std::size_t AUTONS_PER_PAGE = 4;
+
+    // create initializers using drive template params
+    //  add extra motors params
+    bool is_auton_selector_enabled = false;
+
+    ~GUI();
+
+    /**
+     * @brief Starts the GUI task, which applies posted updates, runs the
+     * frame callbacks and calls update() every `period` milliseconds. Only
+     * post to the GUI from other tasks after this.
+     *
+     */
+    void start(uint32_t period = 20,
+               uint32_t frame_budget = DEFAULT_FRAME_BUDGET);
+    void stop();
+    bool is_running() const;
+
+    /**
+     * @brief Calls `function` on the GUI task before every update, for
+     * widgets that pull their data such as gui::MotorDashboard::refresh().
+     * Call before start().
+     *
+     * @return false if MAX_FRAME_CALLBACKS are added
+     */
+    bool add_frame_callback(void (*function)(void* context), void* context);
+
+    /**
+     * @brief Queues an update for the GUI task. Safe to call from any task,
+     * never blocks.
+     *
+     * A post is a copy into the queue. On a desktop it averages about 20 ns,
+     * and timed one at a time the p99.9 stays within a few hundred ns, while
+     * the slowest posts take microseconds when the OS preempts the benchmark
+     * (`make -C tools benchmark BENCHMARK_FLAGS="--filter gui"`). It has not
+     * been timed on the brain.
+     *
+     * @return false if the queue was full and the update was dropped
+     */
+    bool post_text(gui::Label& label, const char* text);
+    /**
+     * @brief Like post_text, but formats the text with vsnprintf on the
+     * calling task first. That costs 0.3 to 0.7 us on a desktop, and far
+     * more on the brain, so post_text or post_value fit tight control loops
+     * better.
+     *
+     */
+    bool post_print(gui::Label& label, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+    bool post_value(gui::Bar& bar, double value);
+    bool post_samples(gui::Plot& plot, std::initializer_list<double> values);
+    bool post_pose(gui::FieldMap& map, const Pose& pose);
+    bool post_page(gui::Page& page);
+    /**
+     * @brief Queues `function` to be called on the GUI task
+     *
+     */
+    bool post(void (*function)(void* context), void* context);
+
+    /**
+     * @brief Shows `page` from the next update on. The screen is cleared and
+     * every widget of the page is drawn again.
+     *
+     */
+    void set_page(gui::Page& page);
+    gui::Page* get_page() const;
+    void set_background(uint32_t color);
+
+    /**
+     * @brief Passes new touch events to the page and draws dirty widgets
+     * until `frame_budget` microseconds have passed. At least one dirty
+     * widget is drawn per call.
+     *
+     * @return The number of widgets drawn
+     */
+    std::size_t update(uint32_t frame_budget = DEFAULT_FRAME_BUDGET);
+
+    /**
+     * @brief Registers an autonomous routine with the selector. Call before
+     * show_auton_selector().
+     *
+     * @param name Shown on the selector and saved to the SD card, so it
+     * should stay the same between program versions
+     * @param description Shown while the routine is selected
+     * @return false if MAX_AUTONS routines are registered
+     */
+    bool add_auton(const char* name, const char* description,
+                   void (*autonomous_function)());
+    /**
+     * @brief Loads the last selection from the SD card and shows the
+     * selector page. Selections are saved to `path` as they are made, so a
+     * brain reboot between matches keeps them. Call before start(), or
+     * through post() once the GUI task runs.
+     *
+     */
+    void show_auton_selector(const char* path = "/usd/apollo_auton.txt");
+    /**
+     * @brief The selected routine, or nullptr if none are registered. Never
+     * touches the SD card, so it is safe to call at the start of
+     * autonomous().
+     *
+     */
+    const auton* get_selected_auton() const;
+    int get_selected_auton_index() const;
+    field_side get_field_side() const;
+    int get_auton_count() const;
+    /**
+     * @brief Name of a registered routine, or nullptr if there is none at
+     * `index`
+     *
+     */
+    const char* get_auton_name(int index) const;
+    /**
+     * @brief Queues a selection for the GUI task, which shows and saves it
+     * as if it was tapped on the selector. Safe to call from any task, for
+     * example a controller menu.
+     *
+     * @return false if the queue was full or there is no routine at `index`
+     */
+    bool post_auton_selection(int index, field_side side);
+    /**
+     * @brief Runs the selected routine
+     *
+     * @return false if no routine is registered
+     */
+    bool run_selected_auton() const;
+
+   private:
+    struct AutonSelectorPage;
+
+    enum message_type : uint8_t {
+      MESSAGE_TEXT,
+      MESSAGE_VALUE,
+      MESSAGE_SAMPLES,
+      MESSAGE_POSE,
+      MESSAGE_PAGE,
+      MESSAGE_AUTON,
+      MESSAGE_CALLBACK
+    };
+
+    struct Message {
+      message_type type;
+      uint8_t count;
+      void* target;
+      void (*function)(void* context);
+      union {
+        char text[gui::Label::TEXT_SIZE];
+        double values[gui::Plot::MAX_SERIES];
+      };
+    };
+
+    struct FrameCallback {
+      void (*function)(void* context);
+      void* context;
+    };
+
+    bool push(const Message& message);
+    void gui_loop(uint32_t period, uint32_t frame_budget);
+    void apply(const Message& message);
+    void dispatch_touch();
+    void show_auton_page(int page);
+    void select_auton(int index);
+    void select_field_side(field_side side);
+    void apply_auton_selection(int index, field_side side);
+    bool load_auton_selection();
+    bool save_auton_selection();
+    template <int BUTTON>
+    static void on_auton_pressed(void* context);
+    static void on_previous_page_pressed(void* context);
+    static void on_next_page_pressed(void* context);
+    static void on_left_side_pressed(void* context);
+    static void on_right_side_pressed(void* context);
+
+    telemetry::RingBuffer<Message, QUEUE_CAPACITY> queue;
+    FrameCallback frame_callbacks[MAX_FRAME_CALLBACKS];
+    std::size_t frame_callback_count = 0;
+    pros::Task* gui_task = nullptr;
+    std::atomic<bool> running{false};
+
+    gui::Page* page = nullptr;
+    uint32_t background = gui::COLOR_BACKGROUND;
+    bool needs_clear = false;
+    std::size_t next_widget = 0;
+    int32_t press_count = 0;
+    int32_t release_count = 0;
+
+    auton autons[MAX_AUTONS];
+    int total_autons = 0;
+    // Written by the task running the selector, read by autonomous()
+    std::atomic<int> selected_auton{0};
+    std::atomic<field_side> selected_side{FIELD_SIDE_LEFT};
+    int curent_auton_page = 0;
+    const char* auton_file_path = nullptr;
+    AutonSelectorPage* auton_selector = nullptr;
+  };
+}  // namespace apollo
+
+/**
+ * @brief The brain screen's GUI. Started by initialize().
+ *
+ */
+extern apollo::GUI brain_gui;
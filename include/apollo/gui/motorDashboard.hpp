@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/gui/widget.hpp"
+#include "pros/abstract_motor.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  /**
+   * @brief Longest motor name, including the terminator
+   *
+   */
+  constexpr std::size_t MOTOR_NAME_SIZE = 12;
+
+  struct motor {
+    char name[MOTOR_NAME_SIZE];
+    int8_t port;
+    pros::MotorGears cartridge;
+    bool is_reversed;
+  };
+
+  namespace gui {
+    /**
+     * @brief One reading of a motor
+     *
+     */
+    struct MotorSnapshot {
+      /**
+       * @brief Degrees Celsius
+       *
+       */
+      float temperature = 0.0f;
+      /**
+       * @brief Milliamps
+       *
+       */
+      int32_t current = 0;
+      /**
+       * @brief RPM at the motor's cartridge
+       *
+       */
+      float velocity = 0.0f;
+      /**
+       * @brief pros::motor_fault_e_t flags
+       *
+       */
+      uint32_t faults = 0;
+      bool is_connected = false;
+    };
+
+    /**
+     * @brief Diagnostics page listing every registered motor with its
+     * temperature, current, velocity and fault flags.
+     *
+     * A low priority task reads all motors in one pass and publishes them as
+     * one snapshot. refresh() copies the newest snapshot with a single lock
+     * and only updates rows whose text changed, so the GUI task never waits
+     * on a motor and an idle robot costs no drawing. Names are stored in
+     * fixed buffers, so registering every port allocates nothing.
+     *
+     * Rows show the name, port, temperature, current, velocity and a letter
+     * per fault: T over temperature, D driver fault, C over current. Rows of
+     * faulted or unplugged motors are drawn in red.
+     *
+     * @code
+     * gui::MotorDashboard dashboard;
+     * dashboard.add_motor("left 1", -1, pros::MotorGears::blue);
+     * dashboard.start();
+     * brain_gui.add_frame_callback(
+     *     [](void* dashboard) {
+     *       static_cast<gui::MotorDashboard*>(dashboard)->refresh();
+     *     },
+     *     &dashboard);
+     * brain_gui.post_page(dashboard.get_page());
+     * @endcode
+     */
+    class MotorDashboard {
+     public:
+      static constexpr std::size_t MAX_MOTORS = 20;
+
+      /**
+       * @brief Construct a new Motor Dashboard
+       *
+       * @param period Milliseconds between snapshots
+       */
+      explicit MotorDashboard(uint32_t period = 100);
+      ~MotorDashboard();
+
+      /**
+       * @brief Registers a motor. Call before start().
+       *
+       * @param name Cut to MOTOR_NAME_SIZE - 1 characters
+       * @param port Negative if the motor is reversed
+       * @return false if MAX_MOTORS motors are registered
+       */
+      bool add_motor(const char* name, int8_t port,
+                     pros::MotorGears cartridge = pros::MotorGears::green);
+      std::size_t get_motor_count() const;
+      const motor& get_motor(std::size_t index) const;
+      MotorSnapshot get_snapshot(std::size_t index) const;
+
+      void start();
+      void stop();
+
+      Page& get_page();
+      /**
+       * @brief Updates the rows from the newest snapshot. Call from the task
+       * that renders the page.
+       *
+       */
+      void refresh();
+
+     private:
+      void sample_loop();
+      void sample();
+
+      motor motors[MAX_MOTORS];
+      std::size_t motor_count = 0;
+      uint32_t period;
+      pros::Task* sample_task = nullptr;
+      std::atomic<bool> running{false};
+
+      mutable pros::Mutex snapshot_mutex;
+      MotorSnapshot snapshot[MAX_MOTORS];
+      uint32_t snapshot_count = 0;
+
+      // Only touched by the task rendering the page
+      Page page;
+      Label title;
+      Label rows[MAX_MOTORS];
+      bool is_row_alert[MAX_MOTORS] = {};
+      uint32_t shown_snapshot_count = 0;
+    };
+  }  // namespace gui
+}  // namespace apollo
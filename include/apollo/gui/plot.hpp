@@ -0,0 +1,105 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "apollo/gui/widget.hpp"
+
+namespace apollo {
+  namespace gui {
+    /**
+     * @brief Live graph of up to MAX_SERIES values, such as error, velocity
+     * and voltage of a controller being tuned.
+     *
+     * Every `samples_per_column` samples are reduced to their minimum and
+     * maximum, which become one pixel column. Spikes shorter than a column
+     * still show, and several seconds of 100 Hz data fit the screen width
+     * without drawing every point. For example, 5 s of 100 Hz data on a
+     * 250 pixel wide plot needs 2 samples per column.
+     *
+     * The plot is drawn like an oscilloscope: a cursor sweeps left to right
+     * and wraps around, and each update only erases and draws the columns
+     * completed since the last one. The rest of the plot is never redrawn.
+     *
+     * @code
+     * gui::Plot plot({0, 40, 479, 239}, -12000, 12000, 2);
+     * plot.add_series(gui::COLOR_ACCENT);
+     * plot.add_series(static_cast<uint32_t>(pros::Color::orange));
+     * // every 10 ms
+     * plot.push({error, voltage});
+     * @endcode
+     */
+    class Plot : public Widget {
+     public:
+      static constexpr std::size_t MAX_SERIES = 3;
+      static constexpr std::size_t MAX_COLUMNS = SCREEN_WIDTH;
+
+      /**
+       * @brief Construct a new Plot with no series
+       *
+       * @param minimum Value at the bottom edge
+       * @param maximum Value at the top edge
+       * @param samples_per_column Samples reduced into each pixel column
+       */
+      Plot(Rect bounds, double minimum, double maximum,
+           std::size_t samples_per_column = 1);
+
+      /**
+       * @return false if MAX_SERIES series have been added
+       */
+      bool add_series(uint32_t color);
+      /**
+       * @brief Adds one sample to each series, in the order they were added.
+       * Missing values leave their series without a sample.
+       *
+       */
+      void push(std::initializer_list<double> values);
+      void push(const double* values, std::size_t count);
+      void clear();
+      void set_range(double minimum, double maximum);
+      void set_samples_per_column(std::size_t samples_per_column);
+
+     protected:
+      void draw(bool is_full_redraw) override;
+
+     private:
+      struct Column {
+        float minimum;
+        float maximum;
+        bool is_empty;
+      };
+      static constexpr Column EMPTY_COLUMN{0.0f, 0.0f, true};
+
+      struct Series {
+        uint32_t color;
+        Column columns[MAX_COLUMNS];
+        Column pending;
+      };
+
+      int16_t to_y(float value) const;
+      void draw_column(uint32_t index);
+      void draw_cursor(uint32_t index);
+
+      double minimum;
+      double maximum;
+      std::size_t samples_per_column;
+      std::size_t column_capacity;
+      Series series[MAX_SERIES];
+      std::size_t series_count = 0;
+      std::size_t pending_samples = 0;
+      /**
+       * @brief Columns completed since the last clear. Column n is stored and
+       * drawn at n % column_capacity.
+       *
+       */
+      uint32_t column_count = 0;
+      uint32_t drawn_column_count = 0;
+    };
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/chassis/chassisModel.hpp"
+#include "apollo/gui/widget.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace gui {
+    enum preflight_status {
+      PREFLIGHT_PENDING,
+      PREFLIGHT_OK,
+      PREFLIGHT_WARNING,
+      PREFLIGHT_FAILED
+    };
+
+    /**
+     * @brief Outcome of checking one device or the battery
+     *
+     */
+    struct PreflightResult {
+      preflight_status status = PREFLIGHT_PENDING;
+      /**
+       * @brief Short reason, e.g. "ok", "missing" or "calibrating". Always
+       * a string literal.
+       *
+       */
+      const char* detail = "";
+    };
+
+    /**
+     * @brief Pre-match screen that checks every configured port.
+     *
+     * Each motor, IMU and rotation sensor is checked for a device of the
+     * right type with pros::Device. ADI encoders are checked for their port
+     * configuration, and for a plugged in expander when they are on one;
+     * the ADI can't tell whether an encoder is actually connected. The IMU
+     * row waits for calibration to finish and fails on an IMU error, and
+     * the battery row fails below the minimum charge.
+     *
+     * Probing runs in its own low priority task and repeats every period,
+     * so it overlaps IMU calibration instead of waiting for it and picks up
+     * cables plugged in while the screen is up. One pass reads every port
+     * and publishes the results under a single lock; refresh() only
+     * updates rows whose result changed.
+     *
+     * @code
+     * gui::PreflightCheck preflight;
+     * preflight.add_chassis(chassis);
+     * preflight.start();
+     * brain_gui.add_frame_callback(
+     *     [](void* preflight) {
+     *       static_cast<gui::PreflightCheck*>(preflight)->refresh();
+     *     },
+     *     &preflight);
+     * brain_gui.post_page(preflight.get_page());
+     * @endcode
+     */
+    class PreflightCheck {
+     public:
+      /**
+       * @brief Devices that can be checked, besides the battery
+       *
+       */
+      static constexpr std::size_t MAX_DEVICES = 19;
+
+      /**
+       * @brief Construct a new Preflight Check
+       *
+       * @param minimum_battery Lowest battery charge that passes, in percent
+       * @param period Milliseconds between probing passes
+       */
+      explicit PreflightCheck(double minimum_battery = 70.0,
+                              uint32_t period = 100);
+      ~PreflightCheck();
+
+      PreflightCheck(const PreflightCheck&) = delete;
+      PreflightCheck& operator=(const PreflightCheck&) = delete;
+
+      /**
+       * @brief Adds every device the chassis was constructed with. Call
+       * before start().
+       *
+       * @return false if some devices did not fit
+       */
+      bool add_chassis(const ChassisModel& chassis);
+      /**
+       * @brief Adds a device outside the chassis, like an intake motor. Call
+       * before start().
+       *
+       * @return false if MAX_DEVICES devices are added
+       */
+      bool add_device(const chassis_device& device);
+      std::size_t get_device_count() const;
+
+      void start();
+      void stop();
+
+      PreflightResult get_result(std::size_t index) const;
+      PreflightResult get_battery_result() const;
+      /**
+       * @brief false until a pass finds nothing pending, like a calibrating
+       * IMU
+       *
+       */
+      bool is_complete() const;
+      /**
+       * @brief Devices and battery that failed in the last pass
+       *
+       */
+      std::size_t get_failure_count() const;
+
+      Page& get_page();
+      /**
+       * @brief Updates the rows from the last pass. Call from the task that
+       * renders the page.
+       *
+       */
+      void refresh();
+
+     private:
+      void probe_loop();
+      void probe();
+
+      chassis_device devices[MAX_DEVICES];
+      std::size_t device_count = 0;
+      double minimum_battery;
+      uint32_t period;
+      pros::Task* probe_task = nullptr;
+      std::atomic<bool> running{false};
+
+      mutable pros::Mutex result_mutex;
+      PreflightResult results[MAX_DEVICES];
+      PreflightResult battery_result;
+      double battery_capacity = 0.0;
+      uint32_t pass_count = 0;
+
+      // Only touched by the task rendering the page
+      Page page;
+      Label title;
+      Label battery_row;
+      Label rows[MAX_DEVICES];
+      preflight_status shown_status[MAX_DEVICES + 1] = {};
+      uint32_t shown_pass_count = 0;
+    };
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,146 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "apollo/gui/widget.hpp"
+#include "apollo/tuning/parameterRegistry.hpp"
+
+namespace apollo {
+  namespace gui {
+    /**
+     * @brief Called after the panel changed one or more parameters
+     *
+     */
+    using TuningCallback = void (*)(void* context);
+
+    /**
+     * @brief Touch page for editing a ParameterRegistry between matches.
+     *
+     * Every registered parameter gets a row with its name, its value, a
+     * slider over its range and buttons that move it by one step. Pages of
+     * ROWS_PER_PAGE rows are flipped with the arrow buttons. A change is a
+     * single atomic store into the registry, so control loops reading a
+     * Parameter handle pick it up on their next tick without locking.
+     *
+     * Values that live outside the registry, like the chassis deadband and
+     * drive curve, are pushed from the change callback, which also runs
+     * after load(). The file is the registry's `name value` format and is
+     * read with a single read at boot.
+     *
+     * The panel's widgets belong to the GUI task: call refresh() from a
+     * frame callback so edits made through ParameterConsole show up too.
+     *
+     * @code
+     * ParameterRegistry parameters;
+     * Parameter<int> deadband = parameters.add("drive.deadband", 5, 0, 30);
+     * Parameter<double> curve = parameters.add("drive.curve", 0.0, 0.0, 1.0,
+     *                                          0.05);
+     * gui::TuningPanel tuning(parameters);
+     * tuning.set_change_callback(
+     *     [](void*) {
+     *       chassis.set_joystick_deadband(deadband.get());
+     *       chassis.set_drive_curve(curve.get());
+     *     },
+     *     nullptr);
+     * tuning.load();
+     * brain_gui.add_frame_callback(
+     *     [](void* tuning) {
+     *       static_cast<gui::TuningPanel*>(tuning)->refresh();
+     *     },
+     *     &tuning);
+     * brain_gui.post_page(tuning.get_page());
+     * @endcode
+     */
+    class TuningPanel {
+     public:
+      static constexpr std::size_t ROWS_PER_PAGE = 4;
+
+      /**
+       * @brief Construct a new Tuning Panel
+       *
+       * @param path File load() and the save button use. Must outlive the
+       * panel, which a string literal does.
+       */
+      explicit TuningPanel(ParameterRegistry& registry,
+                           const char* path = "/usd/apollo_params.txt");
+
+      TuningPanel(const TuningPanel&) = delete;
+      TuningPanel& operator=(const TuningPanel&) = delete;
+
+      void set_change_callback(TuningCallback callback, void* context);
+
+      /**
+       * @brief Reads the parameter file and runs the change callback. Call
+       * once at boot, after every parameter is registered and before the
+       * page is shown.
+       *
+       * @return false if the file can't be read
+       */
+      bool load();
+      /**
+       * @return false if the file can't be written
+       */
+      bool save();
+
+      Page& get_page();
+      /**
+       * @brief Updates rows whose parameter changed outside the panel. Call
+       * from the task that renders the page.
+       *
+       */
+      void refresh();
+
+     private:
+      struct Row {
+        Label name;
+        Label value;
+        Button decrease{Rect{0, 0, 0, 0}, "-"};
+        Slider slider{Rect{0, 0, 0, 0}, 0.0, 1.0};
+        Button increase{Rect{0, 0, 0, 0}, "+"};
+        double shown_value = 0.0;
+      };
+
+      int get_page_count() const;
+      /**
+       * @brief Index of the parameter shown in `row`, or -1 if the row is
+       * empty
+       *
+       */
+      int get_parameter(std::size_t row) const;
+      void show_page(int page);
+      void show_value(std::size_t row);
+      void changed(std::size_t row);
+
+      template <int ROW>
+      static void on_decrease_pressed(void* context);
+      template <int ROW>
+      static void on_increase_pressed(void* context);
+      template <int ROW>
+      static void on_slider_moved(void* context, double value);
+      static void on_previous_page_pressed(void* context);
+      static void on_next_page_pressed(void* context);
+      static void on_load_pressed(void* context);
+      static void on_save_pressed(void* context);
+
+      ParameterRegistry& registry;
+      const char* path;
+      TuningCallback change_callback = nullptr;
+      void* change_context = nullptr;
+
+      Page page;
+      Label title;
+      Label status;
+      Row rows[ROWS_PER_PAGE];
+      Button previous_page;
+      Button next_page;
+      Button load_button;
+      Button save_button;
+      int current_page = 0;
+    };
+  }  // namespace gui
+}  // namespace apollo
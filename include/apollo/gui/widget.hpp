@@ -0,0 +1,266 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pros/colors.hpp"
+#include "pros/screen.h"
+
+namespace apollo {
+  namespace gui {
+    constexpr int16_t SCREEN_WIDTH = 480;
+    constexpr int16_t SCREEN_HEIGHT = 240;
+
+    constexpr uint32_t COLOR_BACKGROUND =
+        static_cast<uint32_t>(pros::Color::black);
+    constexpr uint32_t COLOR_FOREGROUND =
+        static_cast<uint32_t>(pros::Color::white);
+    constexpr uint32_t COLOR_ACCENT =
+        static_cast<uint32_t>(pros::Color::dodger_blue);
+    constexpr uint32_t COLOR_MUTED =
+        static_cast<uint32_t>(pros::Color::dim_gray);
+
+    /**
+     * @brief Screen area in pixels. Both corners are inclusive, matching
+     * pros::screen.
+     *
+     */
+    struct Rect {
+      int16_t x0;
+      int16_t y0;
+      int16_t x1;
+      int16_t y1;
+
+      constexpr int16_t get_width() const { return x1 - x0 + 1; }
+      constexpr int16_t get_height() const { return y1 - y0 + 1; }
+      constexpr bool contains(int16_t x, int16_t y) const {
+        return x >= x0 && x <= x1 && y >= y0 && y <= y1;
+      }
+    };
+
+    /**
+     * @brief A retained element of the screen.
+     *
+     * A widget keeps the state it shows and only marks itself dirty when a
+     * setter changes what would be drawn. GUI draws dirty widgets and skips
+     * the rest, so an unchanged screen issues no pros::screen calls. Widgets
+     * of a page must not overlap, since each one only redraws its own
+     * bounds.
+     *
+     * Widgets are not thread safe. Change them from the task that renders
+     * them, or through the GUI task's queue.
+     */
+    class Widget {
+     public:
+      explicit Widget(Rect bounds);
+      virtual ~Widget() = default;
+
+      const Rect& get_bounds() const;
+      void set_bounds(Rect bounds);
+      void set_colors(uint32_t foreground, uint32_t background);
+
+      bool is_dirty() const;
+      /**
+       * @brief The contents changed. Draw them on the next render.
+       *
+       */
+      void mark_dirty();
+      /**
+       * @brief The screen under the widget was lost, for example by a page
+       * switch. Redraw all of it on the next render.
+       *
+       */
+      void invalidate();
+      /**
+       * @brief Draws the widget if it is dirty
+       *
+       */
+      void render();
+
+      /**
+       * @brief Handles a touch event at (x, y)
+       *
+       * @return true if the widget used the event
+       */
+      virtual bool touch(int16_t x, int16_t y, pros::last_touch_e_t event);
+
+     protected:
+      /**
+       * @brief Issues the draw calls
+       *
+       * @param is_full_redraw true if the area must be drawn from scratch,
+       * false if only what changed since the last draw needs drawing
+       */
+      virtual void draw(bool is_full_redraw) = 0;
+      void clear_background() const;
+      void clear_area(const Rect& area) const;
+
+      Rect bounds;
+      uint32_t foreground = COLOR_FOREGROUND;
+      uint32_t background = COLOR_BACKGROUND;
+
+     private:
+      bool dirty = true;
+      bool needs_full_redraw = true;
+    };
+
+    /**
+     * @brief One line of text
+     *
+     */
+    class Label : public Widget {
+     public:
+      static constexpr std::size_t TEXT_SIZE = 48;
+
+      /**
+       * @brief Construct a new Label. A label without bounds is placed with
+       * set_bounds() before it is shown.
+       *
+       */
+      Label(Rect bounds = Rect{0, 0, 0, 0}, const char* text = "",
+            pros::text_format_e_t text_format = pros::E_TEXT_SMALL);
+
+      void set_text(const char* text);
+      void print(const char* format, ...) __attribute__((format(printf, 2, 3)));
+      const char* get_text() const;
+
+     protected:
+      void draw(bool is_full_redraw) override;
+
+     private:
+      char text[TEXT_SIZE];
+      pros::text_format_e_t text_format;
+    };
+
+    /**
+     * @brief Horizontal bar filled in proportion to a value. A value change
+     * that moves the fill by less than a pixel does not redraw, and a
+     * redraw only fills or erases the pixels that changed.
+     *
+     */
+    class Bar : public Widget {
+     public:
+      Bar(Rect bounds, double minimum, double maximum);
+
+      void set_value(double value);
+      double get_value() const;
+      void set_fill_color(uint32_t color);
+
+     protected:
+      void draw(bool is_full_redraw) override;
+
+      double minimum;
+      double maximum;
+
+     private:
+      int16_t get_fill_width(double value) const;
+
+      double value;
+      uint32_t fill_color = COLOR_ACCENT;
+      int16_t drawn_fill = 0;
+    };
+
+    /**
+     * @brief Called with the value a slider was moved to
+     *
+     */
+    using SliderCallback = void (*)(void* context, double value);
+
+    /**
+     * @brief Bar that is set by touching it. The value jumps to where the
+     * bar is pressed and again to where it is released, so dragging across
+     * it and letting go picks the value under the finger.
+     *
+     */
+    class Slider : public Bar {
+     public:
+      Slider(Rect bounds, double minimum, double maximum,
+             SliderCallback callback = nullptr, void* context = nullptr);
+
+      /**
+       * @brief Changes the slider's range. The value is kept.
+       *
+       */
+      void set_range(double minimum, double maximum);
+      /**
+       * @brief A slider without a callback ignores touches
+       *
+       */
+      void set_callback(SliderCallback callback, void* context);
+
+      bool touch(int16_t x, int16_t y, pros::last_touch_e_t event) override;
+
+     private:
+      double get_touch_value(int16_t x) const;
+
+      SliderCallback callback;
+      void* context;
+      bool is_pressed = false;
+    };
+
+    /**
+     * @brief Called when a button is released over it
+     *
+     */
+    using ButtonCallback = void (*)(void* context);
+
+    /**
+     * @brief Outlined text that runs a callback when tapped
+     *
+     */
+    class Button : public Widget {
+     public:
+      Button(Rect bounds, const char* text, ButtonCallback callback = nullptr,
+             void* context = nullptr);
+
+      void set_text(const char* text);
+      void set_callback(ButtonCallback callback, void* context);
+      /**
+       * @brief A selected button is drawn filled, for example the chosen
+       * entry of a list
+       *
+       */
+      void set_selected(bool selected);
+      bool is_selected() const;
+
+      bool touch(int16_t x, int16_t y, pros::last_touch_e_t event) override;
+
+     protected:
+      void draw(bool is_full_redraw) override;
+
+     private:
+      char text[Label::TEXT_SIZE];
+      ButtonCallback callback;
+      void* context;
+      bool is_pressed = false;
+      bool selected = false;
+    };
+
+    /**
+     * @brief The widgets shown together on the screen. A page only refers
+     * to its widgets, which must outlive it.
+     *
+     */
+    class Page {
+     public:
+      static constexpr std::size_t MAX_WIDGETS = 32;
+
+      /**
+       * @return false if the page is full
+       */
+      bool add(Widget& widget);
+      std::size_t size() const;
+      Widget& get_widget(std::size_t index) const;
+      void invalidate();
+
+     private:
+      Widget* widgets[MAX_WIDGETS];
+      std::size_t widget_count = 0;
+    };
+  }  // namespace gui
+}  // namespace apollo
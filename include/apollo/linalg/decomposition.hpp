@@ -0,0 +1,266 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "apollo/linalg/matrix.hpp"
+
+namespace apollo {
+  namespace linalg {
+    /**
+     * @brief Pivots smaller than this are treated as zero
+     *
+     */
+    constexpr double SINGULAR_TOLERANCE = 1e-12;
+
+    /**
+     * @brief LU decomposition with partial pivoting of a square matrix,
+     * computed on raw values. Use it to solve several right hand sides
+     * against the same matrix.
+     *
+     * Every loop is unrolled with static_for, and the triangular bounds
+     * become constant conditions the compiler folds away. The nest is too
+     * deep for the inliner's default budget, so the entry points are
+     * marked flatten; without it the lambdas stay calls with runtime
+     * indices and run slower than plain loops. Code size grows with N^3,
+     * which is fine for the small sizes Matrix is meant for.
+     *
+     * @tparam N Size of the matrix
+     */
+    template <std::size_t N>
+    class LUDecomposition {
+     public:
+      template <typename T>
+      [[gnu::flatten]] constexpr explicit LUDecomposition(
+          const Matrix<T, N, N>& matrix)
+          : lu(values_of(matrix)) {
+        static_for<N>([&](std::size_t i) { permutation[i] = i; });
+        static_for<N>([&](std::size_t k) {
+          if(singular) {
+            return;
+          }
+          std::size_t pivot = k;
+          static_for<N>([&](std::size_t i) {
+            if(i > k && std::fabs(lu(i, k)) > std::fabs(lu(pivot, k))) {
+              pivot = i;
+            }
+          });
+          if(std::fabs(lu(pivot, k)) < SINGULAR_TOLERANCE) {
+            singular = true;
+            return;
+          }
+          if(pivot != k) {
+            static_for<N>([&](std::size_t j) {
+              const double temp = lu(k, j);
+              lu(k, j) = lu(pivot, j);
+              lu(pivot, j) = temp;
+            });
+            const std::size_t temp = permutation[k];
+            permutation[k] = permutation[pivot];
+            permutation[pivot] = temp;
+            is_permutation_odd = !is_permutation_odd;
+          }
+          static_for<N>([&](std::size_t i) {
+            if(i > k) {
+              lu(i, k) /= lu(k, k);
+              static_for<N>([&](std::size_t j) {
+                if(j > k) {
+                  lu(i, j) -= lu(i, k) * lu(k, j);
+                }
+              });
+            }
+          });
+        });
+      }
+
+      constexpr bool is_singular() const { return singular; }
+
+      constexpr double get_determinant() const {
+        if(singular) {
+          return 0.0;
+        }
+        double determinant = is_permutation_odd ? -1.0 : 1.0;
+        static_for<N>([&](std::size_t i) { determinant *= lu(i, i); });
+        return determinant;
+      }
+
+      /**
+       * @brief Solves A * x = b for x. Returns zeros if A is singular.
+       *
+       */
+      template <std::size_t C>
+      [[gnu::flatten]] constexpr Matrix<double, N, C> solve(
+          const Matrix<double, N, C>& b) const {
+        Matrix<double, N, C> x;
+        if(singular) {
+          return x;
+        }
+        static_for<C>([&](std::size_t c) {
+          static_for<N>([&](std::size_t i) {
+            double sum = b(permutation[i], c);
+            static_for<N>([&](std::size_t j) {
+              if(j < i) {
+                sum -= lu(i, j) * x(j, c);
+              }
+            });
+            x(i, c) = sum;
+          });
+          static_for<N>([&](std::size_t step) {
+            const std::size_t i = N - 1 - step;
+            double sum = x(i, c);
+            static_for<N>([&](std::size_t j) {
+              if(j > i) {
+                sum -= lu(i, j) * x(j, c);
+              }
+            });
+            x(i, c) = sum / lu(i, i);
+          });
+        });
+        return x;
+      }
+
+     private:
+      Matrix<double, N, N> lu;
+      std::size_t permutation[N] = {};
+      bool is_permutation_odd = false;
+      bool singular = false;
+    };
+
+    /**
+     * @brief Cholesky decomposition (A = L * L^T) of a symmetric positive
+     * definite matrix, such as a covariance matrix. Half the arithmetic of
+     * LU, though the square roots eat that up on small matrices. Unrolled
+     * the same way as LUDecomposition.
+     *
+     * @tparam N Size of the matrix
+     */
+    template <std::size_t N>
+    class CholeskyDecomposition {
+     public:
+      template <typename T>
+      [[gnu::flatten]] constexpr explicit CholeskyDecomposition(
+          const Matrix<T, N, N>& matrix) {
+        const Matrix<double, N, N> a = values_of(matrix);
+        static_for<N>([&](std::size_t j) {
+          if(!positive_definite) {
+            return;
+          }
+          double diagonal = a(j, j);
+          static_for<N>([&](std::size_t k) {
+            if(k < j) {
+              diagonal -= l(j, k) * l(j, k);
+            }
+          });
+          if(diagonal < SINGULAR_TOLERANCE) {
+            positive_definite = false;
+            return;
+          }
+          l(j, j) = std::sqrt(diagonal);
+          static_for<N>([&](std::size_t i) {
+            if(i > j) {
+              double sum = a(i, j);
+              static_for<N>([&](std::size_t k) {
+                if(k < j) {
+                  sum -= l(i, k) * l(j, k);
+                }
+              });
+              l(i, j) = sum / l(j, j);
+            }
+          });
+        });
+      }
+
+      constexpr bool is_positive_definite() const { return positive_definite; }
+
+      /**
+       * @brief The lower triangular factor L
+       *
+       */
+      constexpr const Matrix<double, N, N>& get_lower() const { return l; }
+
+      /**
+       * @brief Solves A * x = b for x. Returns zeros if A is not positive
+       * definite.
+       *
+       */
+      template <std::size_t C>
+      [[gnu::flatten]] constexpr Matrix<double, N, C> solve(
+          const Matrix<double, N, C>& b) const {
+        Matrix<double, N, C> x;
+        if(!positive_definite) {
+          return x;
+        }
+        static_for<C>([&](std::size_t c) {
+          static_for<N>([&](std::size_t i) {
+            double sum = b(i, c);
+            static_for<N>([&](std::size_t k) {
+              if(k < i) {
+                sum -= l(i, k) * x(k, c);
+              }
+            });
+            x(i, c) = sum / l(i, i);
+          });
+          static_for<N>([&](std::size_t step) {
+            const std::size_t i = N - 1 - step;
+            double sum = x(i, c);
+            static_for<N>([&](std::size_t k) {
+              if(k > i) {
+                sum -= l(k, i) * x(k, c);
+              }
+            });
+            x(i, c) = sum / l(i, i);
+          });
+        });
+        return x;
+      }
+
+     private:
+      Matrix<double, N, N> l;
+      bool positive_definite = true;
+    };
+
+    /**
+     * @brief Solves A * x = b. Units carry through, so a matrix of QTime
+     * against a vector of QLength yields a vector of QSpeed.
+     *
+     * @param a Square coefficient matrix
+     * @param b Right hand side
+     * @param x Written with the solution when A is not singular
+     * @return false if A is singular, in which case x is left untouched
+     */
+    template <typename TA, typename TB, std::size_t N, std::size_t C>
+    constexpr bool solve(const Matrix<TA, N, N>& a, const Matrix<TB, N, C>& b,
+                         Matrix<quotient_t<TB, TA>, N, C>& x) {
+      const LUDecomposition<N> lu(a);
+      if(lu.is_singular()) {
+        return false;
+      }
+      x = with_unit<quotient_t<TB, TA>>(lu.solve(values_of(b)));
+      return true;
+    }
+
+    /**
+     * @brief Inverts A. The result has the inverse unit of A.
+     *
+     * @param a Square matrix to invert
+     * @param result Written with the inverse when A is not singular
+     * @return false if A is singular, in which case result is left untouched
+     */
+    template <typename T, std::size_t N>
+    constexpr bool inverse(const Matrix<T, N, N>& a,
+                           Matrix<inverse_t<T>, N, N>& result) {
+      const LUDecomposition<N> lu(a);
+      if(lu.is_singular()) {
+        return false;
+      }
+      result = with_unit<inverse_t<T>>(
+          lu.solve(Matrix<double, N, N>::identity()));
+      return true;
+    }
+  }  // namespace linalg
+}  // namespace apollo
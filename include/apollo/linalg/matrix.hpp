@@ -0,0 +1,216 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "apollo/units/RQuantity.hpp"
+
+namespace apollo {
+  namespace linalg {
+    /**
+     * @brief Calls `function(i)` for every i in [0, N). The calls are
+     * expanded at compile time, so the loop is unrolled regardless of the
+     * optimization level.
+     *
+     */
+    template <std::size_t N, typename F>
+    constexpr void static_for(F&& function) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (function(I), ...);
+      }(std::make_index_sequence<N>{});
+    }
+
+    /**
+     * @brief Raw value of a matrix element, with any unit stripped
+     *
+     */
+    constexpr double value_of(double value) { return value; }
+    template <typename M, typename L, typename T, typename A>
+    constexpr double value_of(const units::RQuantity<M, L, T, A>& value) {
+      return value.getValue();
+    }
+
+    template <typename T1, typename T2>
+    using product_t = decltype(std::declval<T1>() * std::declval<T2>());
+    template <typename T1, typename T2>
+    using quotient_t = decltype(std::declval<T1>() / std::declval<T2>());
+    template <typename T>
+    using inverse_t = decltype(1.0 / std::declval<T>());
+
+    /**
+     * @brief Fixed-size, row-major matrix stored inline with no heap
+     * allocation.
+     *
+     * Elements are either plain doubles or RQuantity types. With a quantity
+     * element type, every element shares that unit and products, solutions
+     * and inverses carry the correct resulting unit:
+     *
+     * @code
+     * Matrix<units::QTime, 2, 2> a(1_s, 0_s, 0_s, 2_s);
+     * Vector<units::QLength, 2> b(1_m, 4_m);
+     * Vector<units::QSpeed, 2> velocity;
+     * solve(a, b, velocity);  // velocity is (1, 2) m/s
+     * @endcode
+     *
+     * Units are tracked per matrix, not per row or column. A state such as
+     * (position, velocity) or a covariance mixing m^2 and m^2/s has no single
+     * unit, so it has to be a Matrix of doubles in consistent SI units, with
+     * value_of() to strip quantities on the way in.
+     *
+     * @tparam T Element type
+     * @tparam R Number of rows
+     * @tparam C Number of columns
+     */
+    template <typename T, std::size_t R, std::size_t C>
+    class Matrix {
+      static_assert(R > 0 && C > 0, "Matrix dimensions must be non-zero");
+      static_assert(R <= 16 && C <= 16,
+                    "Matrix is meant for small estimator-sized problems");
+
+     public:
+      /**
+       * @brief Construct a zero matrix
+       *
+       */
+      constexpr Matrix() {
+        for(std::size_t i = 0; i < R * C; i++) {
+          data[i] = T(0.0);
+        }
+      }
+      /**
+       * @brief Construct from every element in row-major order
+       *
+       */
+      template <typename... Values>
+        requires(sizeof...(Values) == R * C &&
+                 (std::is_convertible_v<Values, T> && ...))
+      constexpr Matrix(Values... values) : data{static_cast<T>(values)...} {}
+
+      /**
+       * @brief Construct the identity matrix. Only available for square
+       * matrices.
+       *
+       */
+      static constexpr Matrix identity() {
+        static_assert(R == C, "Only square matrices have an identity");
+        Matrix result;
+        for(std::size_t i = 0; i < R; i++) {
+          result(i, i) = T(1.0);
+        }
+        return result;
+      }
+
+      static constexpr std::size_t rows() { return R; }
+      static constexpr std::size_t cols() { return C; }
+
+      constexpr T& operator()(std::size_t row, std::size_t col) {
+        return data[row * C + col];
+      }
+      constexpr const T& operator()(std::size_t row, std::size_t col) const {
+        return data[row * C + col];
+      }
+
+      constexpr Matrix<T, C, R> transpose() const {
+        Matrix<T, C, R> result;
+        static_for<R>([&](std::size_t i) {
+          static_for<C>([&](std::size_t j) { result(j, i) = (*this)(i, j); });
+        });
+        return result;
+      }
+
+      constexpr Matrix& operator+=(const Matrix& rhs) {
+        static_for<R * C>([&](std::size_t i) { data[i] += rhs.data[i]; });
+        return *this;
+      }
+      constexpr Matrix& operator-=(const Matrix& rhs) {
+        static_for<R * C>([&](std::size_t i) { data[i] -= rhs.data[i]; });
+        return *this;
+      }
+      constexpr Matrix& operator*=(double rhs) {
+        static_for<R * C>([&](std::size_t i) { data[i] *= rhs; });
+        return *this;
+      }
+
+     private:
+      T data[R * C];
+    };
+
+    /**
+     * @brief Column vector
+     *
+     */
+    template <typename T, std::size_t N>
+    using Vector = Matrix<T, N, 1>;
+
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<T, R, C> operator+(Matrix<T, R, C> lhs,
+                                        const Matrix<T, R, C>& rhs) {
+      return lhs += rhs;
+    }
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<T, R, C> operator-(Matrix<T, R, C> lhs,
+                                        const Matrix<T, R, C>& rhs) {
+      return lhs -= rhs;
+    }
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<T, R, C> operator*(Matrix<T, R, C> lhs, double rhs) {
+      return lhs *= rhs;
+    }
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<T, R, C> operator*(double lhs, Matrix<T, R, C> rhs) {
+      return rhs *= lhs;
+    }
+
+    /**
+     * @brief Matrix product. Every loop is unrolled at compile time.
+     *
+     */
+    template <typename T1, typename T2, std::size_t R, std::size_t K,
+              std::size_t C>
+    constexpr Matrix<product_t<T1, T2>, R, C> operator*(
+        const Matrix<T1, R, K>& lhs, const Matrix<T2, K, C>& rhs) {
+      Matrix<product_t<T1, T2>, R, C> result;
+      static_for<R>([&](std::size_t i) {
+        static_for<C>([&](std::size_t j) {
+          product_t<T1, T2> sum = lhs(i, 0) * rhs(0, j);
+          static_for<K - 1>(
+              [&](std::size_t k) { sum += lhs(i, k + 1) * rhs(k + 1, j); });
+          result(i, j) = sum;
+        });
+      });
+      return result;
+    }
+
+    /**
+     * @brief Strips the unit from every element
+     *
+     */
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<double, R, C> values_of(const Matrix<T, R, C>& matrix) {
+      Matrix<double, R, C> result;
+      static_for<R>([&](std::size_t i) {
+        static_for<C>(
+            [&](std::size_t j) { result(i, j) = value_of(matrix(i, j)); });
+      });
+      return result;
+    }
+    /**
+     * @brief Attaches the unit `T` to every element
+     *
+     */
+    template <typename T, std::size_t R, std::size_t C>
+    constexpr Matrix<T, R, C> with_unit(const Matrix<double, R, C>& matrix) {
+      Matrix<T, R, C> result;
+      static_for<R>([&](std::size_t i) {
+        static_for<C>([&](std::size_t j) { result(i, j) = T(matrix(i, j)); });
+      });
+      return result;
+    }
+  }  // namespace linalg
+}  // namespace apollo
@@ -0,0 +1,64 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+#include "apollo/units/QAngle.hpp"
+#include "apollo/units/QBinaryAngle.hpp"
+#include "apollo/units/QLength.hpp"
+
+namespace apollo {
+  /**
+   * @brief Position and heading of the robot on the field. Theta is
+   * counter-clockwise positive, with zero along the x axis.
+   *
+   */
+  struct Pose {
+    units::QLength x = units::QLength(0.0);
+    units::QLength y = units::QLength(0.0);
+    units::QAngle theta = units::QAngle(0.0);
+  };
+
+  /**
+   * @brief Tracks the robot's pose from the distance travelled by each side of
+   * the drivetrain and an absolute heading.
+   *
+   * Odometry does not read any devices itself, so the same code runs on the
+   * brain and against recorded telemetry in the native replay tool.
+   */
+  class Odometry {
+   public:
+    Odometry();
+    /**
+     * @brief Sets the current pose. The next update only establishes the
+     * sensor baseline.
+     *
+     */
+    void reset(Pose pose = Pose());
+    /**
+     * @brief Moves the pose without touching the sensor baseline, for
+     * correcting the position mid-run
+     *
+     */
+    void set_pose(Pose pose);
+    /**
+     * @brief Integrates one sample
+     *
+     * @param left_distance Total distance travelled by the left side
+     * @param right_distance Total distance travelled by the right side
+     * @param heading Absolute heading, counter-clockwise positive. For a V5
+     * Inertial Sensor that is `-imu.get_rotation() * units::degree`.
+     */
+    void update(units::QLength left_distance, units::QLength right_distance,
+                units::QAngle heading);
+    Pose get_pose() const;
+
+   private:
+    Pose pose;
+    units::QLength last_left_distance;
+    units::QLength last_right_distance;
+    units::BinaryAngle last_heading;
+    bool has_baseline = false;
+  };
+}  // namespace apollo
@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "apollo/telemetry/telemetryRecord.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace telemetry {
+    /**
+     * @brief Keeps the most recent telemetry in memory and dumps it to the SD
+     * card when something goes wrong.
+     *
+     * log() overwrites the oldest record, so the buffer always holds the
+     * last CAPACITY records. A dump is a regular uncompressed telemetry log
+     * that starts with a BlackBoxRecord, so `tools/telemetry_decode --log`
+     * reads it.
+     *
+     * Dumps are written when the battery voltage drops below the brownout
+     * threshold, when std::terminate is called and when trigger() is called.
+     * PROS has no hook for data aborts, so the buffer is also checkpointed to
+     * a second file every `checkpoint_interval`. After a data abort that file
+     * holds everything up to the last checkpoint.
+     *
+     * Both files are opened by start(). A dump writes at most CAPACITY
+     * records from a fixed staging buffer, so it takes bounded time and never
+     * allocates.
+     */
+    class BlackBox {
+     public:
+      static constexpr std::size_t CAPACITY = 2048;
+      static constexpr std::size_t STAGING_RECORDS = 128;
+      /**
+       * @brief Milliseconds the std::terminate handler waits for a
+       * checkpoint that is being written before dumping the event file
+       *
+       */
+      static constexpr uint32_t TERMINATE_DUMP_TIMEOUT = 1000;
+
+      /**
+       * @brief Construct a new Black Box
+       *
+       * @param file_prefix Dumps go to `<prefix>_event.bin` and checkpoints
+       * to `<prefix>_checkpoint.bin`
+       * @param brownout_voltage Battery voltage in millivolts below which a
+       * dump is written. It is written again only after the battery
+       * recovers.
+       * @param checkpoint_interval Milliseconds between checkpoints, or 0 to
+       * turn them off
+       */
+      explicit BlackBox(const char* file_prefix = "/usd/apollo_blackbox",
+                        int32_t brownout_voltage = 10500,
+                        uint32_t checkpoint_interval = 5000);
+      ~BlackBox();
+
+      /**
+       * @brief Opens the dump files, installs the std::terminate handler and
+       * starts watching the battery
+       *
+       * @return false if no SD card is installed or a file can't be opened
+       */
+      bool start();
+      void stop();
+
+      /**
+       * @brief Records one payload, overwriting the oldest. Safe to call from
+       * any task, never blocks.
+       *
+       */
+      template <typename Payload>
+      void log(const Payload& payload) {
+        const uint32_t index =
+            next_index.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots[index % CAPACITY];
+        // Odd while being written, so a dump skips a half-written slot
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.record =
+            make_record(payload, static_cast<uint32_t>(pros::micros()));
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+      }
+
+      /**
+       * @brief Dumps the buffer now
+       *
+       * @param timeout Milliseconds to wait for a dump that is being written
+       * to finish first
+       * @return false if the black box is not started or another dump was
+       * still being written after `timeout`
+       */
+      bool trigger(black_box_reason reason = BLACK_BOX_MANUAL,
+                   uint32_t timeout = 0);
+
+     private:
+      struct Slot {
+        std::atomic<uint32_t> sequence{0};
+        Record record;
+      };
+
+      void monitor_loop();
+      bool dump(std::FILE* file, black_box_reason reason,
+                uint32_t timeout = 0);
+      static void terminate_handler();
+
+      Slot slots[CAPACITY];
+      std::atomic<uint32_t> next_index{0};
+
+      const char* file_prefix;
+      int32_t brownout_voltage;
+      uint32_t checkpoint_interval;
+      std::FILE* event_file = nullptr;
+      std::FILE* checkpoint_file = nullptr;
+      pros::Task* monitor_task = nullptr;
+      std::atomic<bool> running{false};
+      std::atomic<bool> dumping{false};
+      Record staging[STAGING_RECORDS];
+    };
+  }  // namespace telemetry
+}  // namespace apollo
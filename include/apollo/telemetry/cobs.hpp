@@ -0,0 +1,79 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace apollo {
+  namespace telemetry {
+    /**
+     * @brief Largest possible output of cobs_encode for `length` input bytes,
+     * excluding the 0x00 frame delimiter
+     *
+     */
+    constexpr std::size_t cobs_max_encoded_size(std::size_t length) {
+      return length + length / 254 + 1;
+    }
+
+    /**
+     * Consistent Overhead Byte Stuffing. Rewrites `data` so it contains no
+     * 0x00 bytes, which leaves 0x00 free to delimit frames on a byte stream.
+     * The delimiter itself is not written.
+     *
+     * @param data Bytes to encode
+     * @param length Number of bytes to encode
+     * @param output At least cobs_max_encoded_size(length) bytes
+     * @return Number of bytes written to output
+     */
+    inline std::size_t cobs_encode(const uint8_t* data, std::size_t length,
+                                   uint8_t* output) {
+      std::size_t code_index = 0;
+      std::size_t write_index = 1;
+      uint8_t code = 1;
+      for(std::size_t i = 0; i < length; i++) {
+        if(data[i] != 0) {
+          output[write_index++] = data[i];
+          code++;
+        }
+        if(data[i] == 0 || code == 0xFF) {
+          output[code_index] = code;
+          code = 1;
+          code_index = write_index++;
+        }
+      }
+      output[code_index] = code;
+      return write_index;
+    }
+
+    /**
+     * Reverses cobs_encode. `data` must not include the 0x00 delimiter.
+     *
+     * @param data Encoded bytes
+     * @param length Number of encoded bytes
+     * @param output At least `length` bytes
+     * @return Number of decoded bytes, or 0 if the input is malformed
+     */
+    inline std::size_t cobs_decode(const uint8_t* data, std::size_t length,
+                                   uint8_t* output) {
+      std::size_t read_index = 0;
+      std::size_t write_index = 0;
+      while(read_index < length) {
+        const uint8_t code = data[read_index++];
+        if(code == 0 || read_index + code - 1 > length) {
+          return 0;
+        }
+        for(uint8_t i = 1; i < code; i++) {
+          output[write_index++] = data[read_index++];
+        }
+        if(code != 0xFF && read_index != length) {
+          output[write_index++] = 0;
+        }
+      }
+      return write_index;
+    }
+  }  // namespace telemetry
+}  // namespace apollo
@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace apollo {
+  namespace telemetry {
+    namespace detail {
+      constexpr std::array<uint16_t, 256> make_crc16_table() {
+        std::array<uint16_t, 256> table{};
+        for(uint32_t i = 0; i < 256; i++) {
+          uint16_t crc = static_cast<uint16_t>(i << 8);
+          for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+          }
+          table[i] = crc;
+        }
+        return table;
+      }
+      constexpr std::array<uint16_t, 256> crc16_table = make_crc16_table();
+    }  // namespace detail
+
+    /**
+     * CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) using a
+     * lookup table generated at compile time.
+     *
+     * @param data Bytes to checksum
+     * @param length Number of bytes
+     * @param crc Running value, to checksum data split across several calls
+     * @return The updated checksum
+     */
+    inline uint16_t crc16(const uint8_t* data, std::size_t length,
+                          uint16_t crc = 0xFFFF) {
+      for(std::size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>(
+            (crc << 8) ^ detail::crc16_table[((crc >> 8) ^ data[i]) & 0xFF]);
+      }
+      return crc;
+    }
+  }  // namespace telemetry
+}  // namespace apollo
@@ -0,0 +1,485 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "apollo/telemetry/telemetryRecord.hpp"
+
+/**
+ * Compact encoding for telemetry records. Every field of a known channel is
+ * sent as the zigzag varint of its change since the previous record of the
+ * same channel, so slowly changing encoder positions, voltages and
+ * timestamps shrink to one or two bytes each.
+ *
+ * By default the codec is lossless: float fields are sent as the change of
+ * their bit pattern, which stays small while a value keeps its exponent. A
+ * quantized codec instead rounds float fields to a fixed resolution per
+ * field (see the layouts below) before the difference is taken, which makes
+ * their deltas smaller still, and the decoder reproduces them to within
+ * half that resolution. Encoder and decoder must agree on the mode. Custom
+ * record values have no known scale and are always sent losslessly.
+ *
+ * An encoded record starts with a tag byte: the channel in the low seven
+ * bits and DELTA_KEYFRAME_FLAG if the values are absolute instead of
+ * differences. The first record of every channel is a keyframe, and an
+ * encoder can be asked for more so a decoder can recover from lost data.
+ */
+namespace apollo {
+  namespace telemetry {
+    constexpr uint8_t DELTA_KEYFRAME_FLAG = 0x80;
+    /**
+     * @brief Tag of a record from a channel without a field layout, which is
+     * sent with an absolute timestamp and its payload unchanged
+     *
+     */
+    constexpr uint8_t DELTA_RAW_TAG = 0x7F;
+    constexpr std::size_t DELTA_CHANNEL_COUNT = 8;
+    constexpr std::size_t DELTA_MAX_FIELDS = 8;
+    /**
+     * @brief Largest possible output of DeltaEncoder::encode
+     *
+     */
+    constexpr std::size_t DELTA_MAX_ENCODED_SIZE = 1 + 5 + DELTA_MAX_FIELDS * 5;
+
+    enum field_type : uint8_t {
+      FIELD_INT8,
+      FIELD_INT16,
+      FIELD_UINT16,
+      FIELD_UINT32,
+      FIELD_FLOAT
+    };
+
+    /**
+     * @brief Where one field lives in a payload
+     *
+     */
+    struct FieldLayout {
+      uint8_t offset;
+      field_type type;
+      /**
+       * @brief Float fields of a quantized codec are stored as
+       * round(value * scale). 0 always stores the bit pattern, which is
+       * lossless.
+       *
+       */
+      float scale;
+    };
+
+    namespace detail {
+      inline constexpr FieldLayout DROPPED_FIELDS[] = {
+          {offsetof(DroppedRecord, count), FIELD_UINT32, 0}};
+      // Positions to 0.1 tick, velocities to 0.1 RPM, heading to 0.01 deg
+      inline constexpr FieldLayout CHASSIS_FIELDS[] = {
+          {offsetof(ChassisRecord, left_position), FIELD_FLOAT, 10},
+          {offsetof(ChassisRecord, right_position), FIELD_FLOAT, 10},
+          {offsetof(ChassisRecord, left_velocity), FIELD_FLOAT, 10},
+          {offsetof(ChassisRecord, right_velocity), FIELD_FLOAT, 10},
+          {offsetof(ChassisRecord, left_voltage), FIELD_INT16, 0},
+          {offsetof(ChassisRecord, right_voltage), FIELD_INT16, 0},
+          {offsetof(ChassisRecord, heading), FIELD_FLOAT, 100}};
+      // Position to 0.1 mm, heading to 0.1 mrad
+      inline constexpr FieldLayout POSE_FIELDS[] = {
+          {offsetof(PoseRecord, x), FIELD_FLOAT, 10000},
+          {offsetof(PoseRecord, y), FIELD_FLOAT, 10000},
+          {offsetof(PoseRecord, theta), FIELD_FLOAT, 10000}};
+      inline constexpr FieldLayout CONTROLLER_FIELDS[] = {
+          {offsetof(ControllerRecord, left_x), FIELD_INT8, 0},
+          {offsetof(ControllerRecord, left_y), FIELD_INT8, 0},
+          {offsetof(ControllerRecord, right_x), FIELD_INT8, 0},
+          {offsetof(ControllerRecord, right_y), FIELD_INT8, 0},
+          {offsetof(ControllerRecord, buttons), FIELD_UINT16, 0}};
+      inline constexpr FieldLayout CUSTOM_FIELDS[] = {
+          {offsetof(CustomRecord, id), FIELD_UINT16, 0},
+          {offsetof(CustomRecord, values[0]), FIELD_FLOAT, 0},
+          {offsetof(CustomRecord, values[1]), FIELD_FLOAT, 0},
+          {offsetof(CustomRecord, values[2]), FIELD_FLOAT, 0},
+          {offsetof(CustomRecord, values[3]), FIELD_FLOAT, 0},
+          {offsetof(CustomRecord, values[4]), FIELD_FLOAT, 0}};
+      inline constexpr FieldLayout TRACKER_FIELDS[] = {
+          {offsetof(TrackerRecord, left_position), FIELD_FLOAT, 10},
+          {offsetof(TrackerRecord, right_position), FIELD_FLOAT, 10},
+          {offsetof(TrackerRecord, center_position), FIELD_FLOAT, 10}};
+
+      template <std::size_t N>
+      constexpr std::size_t count_of(const FieldLayout (&)[N]) {
+        return N;
+      }
+
+      inline uint32_t zigzag_encode(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^
+               static_cast<uint32_t>(value >> 31);
+      }
+
+      inline int32_t zigzag_decode(uint32_t value) {
+        return static_cast<int32_t>(value >> 1) ^
+               -static_cast<int32_t>(value & 1);
+      }
+
+      inline std::size_t write_varint(uint32_t value, uint8_t* output) {
+        std::size_t length = 0;
+        while(value >= 0x80) {
+          output[length++] = static_cast<uint8_t>(value | 0x80);
+          value >>= 7;
+        }
+        output[length++] = static_cast<uint8_t>(value);
+        return length;
+      }
+
+      inline bool read_varint(const uint8_t* data, std::size_t length,
+                              std::size_t& index, uint32_t& value) {
+        value = 0;
+        for(int shift = 0; shift < 35; shift += 7) {
+          if(index >= length) {
+            return false;
+          }
+          const uint8_t byte = data[index++];
+          value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+          if((byte & 0x80) == 0) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      /**
+       * @brief Reads a field as the integer its deltas are taken of
+       *
+       */
+      inline int32_t load_field(const uint8_t* payload,
+                                const FieldLayout& field, bool quantized) {
+        switch(field.type) {
+          case FIELD_INT8:
+            return static_cast<int8_t>(payload[field.offset]);
+          case FIELD_INT16: {
+            int16_t value;
+            std::memcpy(&value, payload + field.offset, sizeof(value));
+            return value;
+          }
+          case FIELD_UINT16: {
+            uint16_t value;
+            std::memcpy(&value, payload + field.offset, sizeof(value));
+            return value;
+          }
+          case FIELD_UINT32: {
+            uint32_t value;
+            std::memcpy(&value, payload + field.offset, sizeof(value));
+            return static_cast<int32_t>(value);
+          }
+          case FIELD_FLOAT: {
+            float value;
+            std::memcpy(&value, payload + field.offset, sizeof(value));
+            if(!quantized || field.scale == 0) {
+              int32_t bits;
+              std::memcpy(&bits, &value, sizeof(bits));
+              return bits;
+            }
+            const double scaled = std::round(static_cast<double>(value) *
+                                             static_cast<double>(field.scale));
+            if(!(scaled > INT32_MIN)) {
+              return scaled < 0 ? INT32_MIN : 0;
+            }
+            return scaled < INT32_MAX ? static_cast<int32_t>(scaled)
+                                      : INT32_MAX;
+          }
+        }
+        return 0;
+      }
+
+      inline void store_field(uint8_t* payload, const FieldLayout& field,
+                              int32_t value, bool quantized) {
+        switch(field.type) {
+          case FIELD_INT8:
+            payload[field.offset] = static_cast<uint8_t>(value);
+            break;
+          case FIELD_INT16:
+          case FIELD_UINT16: {
+            const uint16_t bits = static_cast<uint16_t>(value);
+            std::memcpy(payload + field.offset, &bits, sizeof(bits));
+            break;
+          }
+          case FIELD_UINT32:
+            std::memcpy(payload + field.offset, &value, sizeof(value));
+            break;
+          case FIELD_FLOAT: {
+            float result;
+            if(!quantized || field.scale == 0) {
+              std::memcpy(&result, &value, sizeof(result));
+            } else {
+              result = static_cast<float>(static_cast<double>(value) /
+                                          static_cast<double>(field.scale));
+            }
+            std::memcpy(payload + field.offset, &result, sizeof(result));
+            break;
+          }
+        }
+      }
+
+      struct ChannelLayout {
+        const FieldLayout* fields;
+        std::size_t field_count;
+        uint8_t payload_size;
+      };
+
+      /**
+       * @brief Field layout of a channel, with no fields if the channel has
+       * none
+       *
+       */
+      inline ChannelLayout get_channel_layout(uint8_t channel) {
+        switch(channel) {
+          case CHANNEL_DROPPED:
+            return {DROPPED_FIELDS, count_of(DROPPED_FIELDS),
+                    sizeof(DroppedRecord)};
+          case CHANNEL_CHASSIS:
+            return {CHASSIS_FIELDS, count_of(CHASSIS_FIELDS),
+                    sizeof(ChassisRecord)};
+          case CHANNEL_POSE:
+            return {POSE_FIELDS, count_of(POSE_FIELDS), sizeof(PoseRecord)};
+          case CHANNEL_CONTROLLER:
+            return {CONTROLLER_FIELDS, count_of(CONTROLLER_FIELDS),
+                    sizeof(ControllerRecord)};
+          case CHANNEL_CUSTOM:
+            return {CUSTOM_FIELDS, count_of(CUSTOM_FIELDS),
+                    sizeof(CustomRecord)};
+          case CHANNEL_TRACKER:
+            return {TRACKER_FIELDS, count_of(TRACKER_FIELDS),
+                    sizeof(TrackerRecord)};
+          default:
+            return {nullptr, 0, 0};
+        }
+      }
+
+      /**
+       * @brief What the encoder and decoder remember about a channel
+       *
+       */
+      struct ChannelState {
+        bool valid = false;
+        uint16_t since_keyframe = 0;
+        uint32_t timestamp = 0;
+        int32_t values[DELTA_MAX_FIELDS] = {};
+      };
+    }  // namespace detail
+
+    /**
+     * @brief Turns records into delta encoded bytes. Keeps one previous
+     * record per channel and never allocates.
+     *
+     */
+    class DeltaEncoder {
+     public:
+      /**
+       * @brief Construct a new Delta Encoder
+       *
+       * @param keyframe_interval Send a keyframe after this many deltas of a
+       * channel. 0 only sends the first record of a channel as a keyframe.
+       * @param quantized Round float fields to their layout's resolution.
+       * Only for output where size matters more than exact values, like the
+       * serial stream.
+       */
+      explicit DeltaEncoder(uint16_t keyframe_interval = 0,
+                            bool quantized = false)
+          : keyframe_interval(keyframe_interval), quantized(quantized) {}
+
+      bool is_quantized() const { return quantized; }
+
+      /**
+       * @brief Makes the next record of every channel a keyframe
+       *
+       */
+      void reset() {
+        for(detail::ChannelState& state : channels) {
+          state.valid = false;
+        }
+      }
+
+      /**
+       * @brief Encodes one record
+       *
+       * @param record The record to encode
+       * @param output At least DELTA_MAX_ENCODED_SIZE bytes
+       * @return Number of bytes written
+       */
+      std::size_t encode(const Record& record, uint8_t* output) {
+        const uint8_t channel = record.header.channel;
+        const detail::ChannelLayout layout =
+            detail::get_channel_layout(channel);
+        if(layout.fields == nullptr || channel >= DELTA_CHANNEL_COUNT ||
+           record.header.size != layout.payload_size) {
+          return encode_raw(record, output);
+        }
+
+        detail::ChannelState& state = channels[channel];
+        const bool keyframe =
+            !state.valid || (keyframe_interval > 0 &&
+                             state.since_keyframe >= keyframe_interval);
+        if(keyframe) {
+          state = detail::ChannelState();
+          state.valid = true;
+        } else {
+          state.since_keyframe++;
+        }
+
+        std::size_t length = 0;
+        output[length++] = keyframe ? channel | DELTA_KEYFRAME_FLAG : channel;
+        length += detail::write_varint(
+            record.header.timestamp - state.timestamp, output + length);
+        state.timestamp = record.header.timestamp;
+        for(std::size_t i = 0; i < layout.field_count; i++) {
+          const int32_t value =
+              detail::load_field(record.payload, layout.fields[i], quantized);
+          const int32_t delta = static_cast<int32_t>(
+              static_cast<uint32_t>(value) -
+              static_cast<uint32_t>(state.values[i]));
+          length += detail::write_varint(detail::zigzag_encode(delta),
+                                         output + length);
+          state.values[i] = value;
+        }
+        return length;
+      }
+
+     private:
+      static std::size_t encode_raw(const Record& record, uint8_t* output) {
+        const std::size_t size = record.header.size <= RECORD_PAYLOAD_SIZE
+                                     ? record.header.size
+                                     : RECORD_PAYLOAD_SIZE;
+        std::size_t length = 0;
+        output[length++] = DELTA_RAW_TAG;
+        length += detail::write_varint(record.header.timestamp, output + length);
+        output[length++] = record.header.channel;
+        output[length++] = static_cast<uint8_t>(size);
+        std::memcpy(output + length, record.payload, size);
+        return length + size;
+      }
+
+      uint16_t keyframe_interval;
+      bool quantized;
+      detail::ChannelState channels[DELTA_CHANNEL_COUNT];
+    };
+
+    enum decode_result {
+      DECODE_OK,
+      /**
+       * @brief A delta arrived for a channel whose keyframe was lost. It was
+       * skipped and decoding can continue.
+       *
+       */
+      DECODE_NEEDS_KEYFRAME,
+      DECODE_MALFORMED
+    };
+
+    /**
+     * @brief Turns DeltaEncoder output back into records
+     *
+     */
+    class DeltaDecoder {
+     public:
+      /**
+       * @brief Construct a new Delta Decoder
+       *
+       * @param quantized Whether the encoder quantized float fields
+       */
+      explicit DeltaDecoder(bool quantized = false) : quantized(quantized) {}
+
+      /**
+       * @brief Forgets every channel, for example after a corrupt frame.
+       * Deltas are skipped until each channel's next keyframe.
+       *
+       */
+      void reset() {
+        for(detail::ChannelState& state : channels) {
+          state.valid = false;
+        }
+      }
+
+      /**
+       * @brief Decodes one record from the start of `data`
+       *
+       * @param data Encoded bytes
+       * @param length Number of bytes available
+       * @param record Written with the decoded record if DECODE_OK is returned
+       * @param consumed Written with the number of bytes the record used,
+       * unless DECODE_MALFORMED is returned
+       */
+      decode_result decode(const uint8_t* data, std::size_t length,
+                           Record& record, std::size_t& consumed) {
+        std::size_t index = 0;
+        if(length == 0) {
+          return DECODE_MALFORMED;
+        }
+        const uint8_t tag = data[index++];
+        uint32_t value;
+        if(tag == DELTA_RAW_TAG) {
+          if(!detail::read_varint(data, length, index, value) ||
+             index + 2 > length) {
+            return DECODE_MALFORMED;
+          }
+          record.header.timestamp = value;
+          record.header.channel = data[index++];
+          record.header.size = data[index++];
+          record.header.reserved = 0;
+          if(record.header.size > RECORD_PAYLOAD_SIZE ||
+             index + record.header.size > length) {
+            return DECODE_MALFORMED;
+          }
+          std::memset(record.payload, 0, RECORD_PAYLOAD_SIZE);
+          std::memcpy(record.payload, data + index, record.header.size);
+          consumed = index + record.header.size;
+          return DECODE_OK;
+        }
+
+        const uint8_t channel = tag & ~DELTA_KEYFRAME_FLAG;
+        const bool keyframe = (tag & DELTA_KEYFRAME_FLAG) != 0;
+        const detail::ChannelLayout layout =
+            detail::get_channel_layout(channel);
+        if(layout.fields == nullptr || channel >= DELTA_CHANNEL_COUNT) {
+          return DECODE_MALFORMED;
+        }
+
+        // Decode into a copy so a truncated record leaves the state intact
+        detail::ChannelState state =
+            keyframe ? detail::ChannelState() : channels[channel];
+        if(!detail::read_varint(data, length, index, value)) {
+          return DECODE_MALFORMED;
+        }
+        state.timestamp += value;
+        for(std::size_t i = 0; i < layout.field_count; i++) {
+          if(!detail::read_varint(data, length, index, value)) {
+            return DECODE_MALFORMED;
+          }
+          state.values[i] = static_cast<int32_t>(
+              static_cast<uint32_t>(state.values[i]) +
+              static_cast<uint32_t>(detail::zigzag_decode(value)));
+        }
+        consumed = index;
+        if(!keyframe && !state.valid) {
+          return DECODE_NEEDS_KEYFRAME;
+        }
+        state.valid = true;
+        channels[channel] = state;
+
+        record.header.timestamp = state.timestamp;
+        record.header.channel = channel;
+        record.header.size = layout.payload_size;
+        record.header.reserved = 0;
+        std::memset(record.payload, 0, RECORD_PAYLOAD_SIZE);
+        for(std::size_t i = 0; i < layout.field_count; i++) {
+          detail::store_field(record.payload, layout.fields[i],
+                              state.values[i], quantized);
+        }
+        return DECODE_OK;
+      }
+
+     private:
+      bool quantized;
+      detail::ChannelState channels[DELTA_CHANNEL_COUNT];
+    };
+  }  // namespace telemetry
+}  // namespace apollo
@@ -0,0 +1,229 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "apollo/telemetry/deltaCodec.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+
+/**
+ * Native replay of TelemetryLogger files. Recorded sensor samples are fed
+ * back through odometry and controller code, and whatever that code computes
+ * is compared against what the robot recorded. Nothing waits on a clock, so
+ * replay runs as fast as the code under test allows.
+ *
+ * This header is meant for native builds in `tools/`; it is not part of
+ * apollo/api.hpp.
+ */
+namespace apollo {
+  namespace telemetry {
+    /**
+     * @brief Reads every record of a log file into memory, decoding delta
+     * encoded logs
+     *
+     * @return false if the file can't be read or is not an apollo log. A
+     * delta encoded log that ends mid-record still returns the records
+     * before it.
+     */
+    inline bool read_log_file(const char* path, std::vector<Record>& records) {
+      std::FILE* file = std::fopen(path, "rb");
+      if(file == nullptr) {
+        return false;
+      }
+      LogFileHeader header;
+      if(std::fread(&header, sizeof(header), 1, file) != 1 ||
+         std::memcmp(header.magic, LOG_FILE_MAGIC, sizeof(header.magic)) !=
+             0 ||
+         (header.version != LOG_FILE_VERSION &&
+          header.version != LOG_FILE_VERSION_DELTA &&
+          header.version != LOG_FILE_VERSION_DELTA_QUANTIZED) ||
+         header.record_size != RECORD_SIZE) {
+        std::fclose(file);
+        return false;
+      }
+      if(header.version == LOG_FILE_VERSION) {
+        Record block[256];
+        std::size_t count;
+        while((count = std::fread(block, sizeof(Record), 256, file)) > 0) {
+          records.insert(records.end(), block, block + count);
+        }
+        std::fclose(file);
+        return true;
+      }
+
+      std::vector<uint8_t> data;
+      uint8_t block[4096];
+      std::size_t count;
+      while((count = std::fread(block, 1, sizeof(block), file)) > 0) {
+        data.insert(data.end(), block, block + count);
+      }
+      std::fclose(file);
+      DeltaDecoder decoder(header.version == LOG_FILE_VERSION_DELTA_QUANTIZED);
+      Record record;
+      std::size_t index = 0;
+      std::size_t consumed;
+      while(index < data.size()) {
+        const decode_result result = decoder.decode(
+            data.data() + index, data.size() - index, record, consumed);
+        if(result == DECODE_MALFORMED) {
+          break;
+        }
+        if(result == DECODE_OK) {
+          records.push_back(record);
+        }
+        index += consumed;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Drivetrain voltages, in millivolts
+     *
+     */
+    struct ReplayCommand {
+      int16_t left_voltage = 0;
+      int16_t right_voltage = 0;
+    };
+
+    /**
+     * @brief The code under test. Implement it with the same odometry and
+     * controller objects the robot runs.
+     *
+     */
+    class ReplayTarget {
+     public:
+      virtual ~ReplayTarget() = default;
+      /**
+       * @brief Called for every record before it is compared, including
+       * tracker, controller and dropped records
+       *
+       */
+      virtual void on_record(const Record& /*record*/) {}
+      /**
+       * @brief Runs one control tick against the recorded chassis sensors
+       *
+       * @param timestamp Microseconds since the program started
+       * @param chassis Recorded sensors. The recorded voltages are the ones to
+       * reproduce and must not be used as an input.
+       * @param command Written with the voltages the code under test commands
+       * @return false if this target does not compute drive commands
+       */
+      virtual bool step(uint32_t /*timestamp*/,
+                        const ChassisRecord& /*chassis*/,
+                        ReplayCommand& /*command*/) {
+        return false;
+      }
+      /**
+       * @brief The pose estimated so far, compared against recorded poses
+       *
+       * @return false if this target does not estimate a pose
+       */
+      virtual bool get_pose(PoseRecord& /*pose*/) { return false; }
+    };
+
+    struct ReplayStats {
+      std::size_t record_count = 0;
+      /**
+       * @brief DroppedRecords in the log. Targets should restart at each,
+       * since the samples on either side are not consecutive.
+       *
+       */
+      std::size_t gap_count = 0;
+      /**
+       * @brief Records the logger dropped, summed over every gap
+       *
+       */
+      uint32_t dropped_count = 0;
+      std::size_t command_count = 0;
+      std::size_t mismatched_command_count = 0;
+      /**
+       * @brief Largest voltage difference, in millivolts
+       *
+       */
+      int max_command_error = 0;
+      /**
+       * @brief Timestamp of the first command outside the tolerance
+       *
+       */
+      uint32_t first_mismatch_timestamp = 0;
+      std::size_t pose_count = 0;
+      /**
+       * @brief Largest distance between a recorded and replayed pose, in
+       * meters
+       *
+       */
+      double max_pose_error = 0.0;
+      /**
+       * @brief Largest heading difference, in radians
+       *
+       */
+      double max_heading_error = 0.0;
+    };
+
+    /**
+     * @brief Replays `records` through `target` and diffs the results
+     *
+     * @param records Records in the order they were logged
+     * @param target The code under test
+     * @param command_tolerance Voltage differences up to this many millivolts
+     * still count as matching
+     * @return ReplayStats
+     */
+    inline ReplayStats replay(const std::vector<Record>& records,
+                              ReplayTarget& target, int command_tolerance = 0) {
+      ReplayStats stats;
+      ChassisRecord chassis;
+      PoseRecord recorded_pose;
+      DroppedRecord dropped;
+      for(const Record& record : records) {
+        stats.record_count++;
+        target.on_record(record);
+        if(read_record(record, dropped)) {
+          stats.gap_count++;
+          stats.dropped_count += dropped.count;
+        } else if(read_record(record, chassis)) {
+          ReplayCommand command;
+          if(!target.step(record.header.timestamp, chassis, command)) {
+            continue;
+          }
+          stats.command_count++;
+          const int error = std::max(
+              std::abs(command.left_voltage - chassis.left_voltage),
+              std::abs(command.right_voltage - chassis.right_voltage));
+          if(error > stats.max_command_error) {
+            stats.max_command_error = error;
+          }
+          if(error > command_tolerance) {
+            if(stats.mismatched_command_count++ == 0) {
+              stats.first_mismatch_timestamp = record.header.timestamp;
+            }
+          }
+        } else if(read_record(record, recorded_pose)) {
+          PoseRecord pose;
+          if(!target.get_pose(pose)) {
+            continue;
+          }
+          stats.pose_count++;
+          const double error = std::hypot(pose.x - recorded_pose.x,
+                                          pose.y - recorded_pose.y);
+          const double heading_error = std::fabs(
+              std::remainder(pose.theta - recorded_pose.theta, 2 * M_PI));
+          stats.max_pose_error = std::max(stats.max_pose_error, error);
+          stats.max_heading_error =
+              std::max(stats.max_heading_error, heading_error);
+        }
+      }
+      return stats;
+    }
+  }  // namespace telemetry
+}  // namespace apollo
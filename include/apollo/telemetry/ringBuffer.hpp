@@ -0,0 +1,110 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace apollo {
+  namespace telemetry {
+    /**
+     * @brief Bounded lock-free queue with any number of producers and a single
+     * consumer.
+     *
+     * Every cell carries a sequence number that tells producers and the
+     * consumer whose turn it is, so pushing costs one compare-and-swap and a
+     * copy and never blocks. A push into a full buffer fails instead of
+     * waiting, which keeps control loops deterministic.
+     *
+     * @tparam T Trivially copyable element type
+     * @tparam Capacity Number of cells, must be a power of two
+     */
+    template <typename T, std::size_t Capacity>
+    class RingBuffer {
+      static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                    "RingBuffer capacity must be a power of two");
+
+     public:
+      RingBuffer() {
+        for(std::size_t i = 0; i < Capacity; i++) {
+          cells[i].sequence.store(static_cast<uint32_t>(i),
+                                  std::memory_order_relaxed);
+        }
+      }
+      RingBuffer(const RingBuffer&) = delete;
+      RingBuffer& operator=(const RingBuffer&) = delete;
+
+      /**
+       * @brief Copies `item` into the buffer. Safe to call from any task.
+       *
+       * @return false if the buffer is full and the item was dropped
+       */
+      bool push(const T& item) {
+        uint32_t position = tail.load(std::memory_order_relaxed);
+        while(true) {
+          Cell& cell = cells[position & MASK];
+          const uint32_t sequence =
+              cell.sequence.load(std::memory_order_acquire);
+          const int32_t difference = static_cast<int32_t>(sequence - position);
+          if(difference == 0) {
+            if(tail.compare_exchange_weak(position, position + 1,
+                                          std::memory_order_relaxed)) {
+              cell.item = item;
+              cell.sequence.store(position + 1, std::memory_order_release);
+              return true;
+            }
+          } else if(difference < 0) {
+            return false;
+          } else {
+            position = tail.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      /**
+       * @brief Removes the oldest item. Must only be called from one task.
+       *
+       * @return false if the buffer is empty
+       */
+      bool pop(T& item) {
+        Cell& cell = cells[head & MASK];
+        const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(static_cast<int32_t>(sequence - (head + 1)) < 0) {
+          return false;
+        }
+        item = cell.item;
+        cell.sequence.store(head + static_cast<uint32_t>(Capacity),
+                            std::memory_order_release);
+        head++;
+        return true;
+      }
+
+      /**
+       * @brief Number of items waiting. Only exact when called from the
+       * consumer with no producer mid-push.
+       *
+       */
+      std::size_t size() const {
+        return tail.load(std::memory_order_relaxed) - head;
+      }
+
+      static constexpr std::size_t capacity() { return Capacity; }
+
+     private:
+      static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1);
+
+      struct Cell {
+        std::atomic<uint32_t> sequence;
+        T item;
+      };
+
+      Cell cells[Capacity];
+      std::atomic<uint32_t> tail{0};
+      uint32_t head = 0;
+    };
+  }  // namespace telemetry
+}  // namespace apollo
@@ -0,0 +1,166 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "apollo/telemetry/cobs.hpp"
+#include "apollo/telemetry/crc.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+
+/**
+ * Wire format of the serial telemetry stream. Each frame is the record header,
+ * the used part of the payload and a CRC-16 of both, COBS encoded and
+ * terminated by a 0x00 byte. Unused payload bytes are not sent.
+ *
+ * A compressed stream sends packets instead: up to PACKET_MAX_SIZE bytes of
+ * DeltaEncoder output followed by the same CRC-16, framed the same way.
+ */
+namespace apollo {
+  namespace telemetry {
+    constexpr std::size_t FRAME_MAX_RAW_SIZE =
+        sizeof(RecordHeader) + RECORD_PAYLOAD_SIZE + sizeof(uint16_t);
+    /**
+     * @brief Largest encoded frame, including the 0x00 delimiter
+     *
+     */
+    constexpr std::size_t FRAME_MAX_SIZE =
+        cobs_max_encoded_size(FRAME_MAX_RAW_SIZE) + 1;
+
+    constexpr std::size_t PACKET_MAX_SIZE = 128;
+    /**
+     * @brief Largest encoded packet frame, including the 0x00 delimiter
+     *
+     */
+    constexpr std::size_t PACKET_FRAME_MAX_SIZE =
+        cobs_max_encoded_size(PACKET_MAX_SIZE + sizeof(uint16_t)) + 1;
+
+    namespace detail {
+      /**
+       * @brief Appends the CRC to `raw` and COBS encodes it into `output`
+       *
+       * @param raw Bytes to send, with room for two more
+       * @return Number of bytes written, including the delimiter
+       */
+      inline std::size_t finish_frame(uint8_t* raw, std::size_t size,
+                                      uint8_t* output) {
+        const uint16_t crc = crc16(raw, size);
+        raw[size++] = static_cast<uint8_t>(crc & 0xFF);
+        raw[size++] = static_cast<uint8_t>(crc >> 8);
+        const std::size_t encoded_size = cobs_encode(raw, size, output);
+        output[encoded_size] = 0;
+        return encoded_size + 1;
+      }
+
+      /**
+       * @brief Reverses finish_frame
+       *
+       * @param raw At least `length` bytes
+       * @return Number of bytes before the CRC, or -1 if the frame is
+       * malformed or its CRC does not match
+       */
+      inline int open_frame(const uint8_t* data, std::size_t length,
+                            uint8_t* raw) {
+        const std::size_t size = cobs_decode(data, length, raw);
+        if(size < sizeof(uint16_t)) {
+          return -1;
+        }
+        const std::size_t checked_size = size - sizeof(uint16_t);
+        const uint16_t crc = static_cast<uint16_t>(
+            raw[checked_size] | (raw[checked_size + 1] << 8));
+        if(crc != crc16(raw, checked_size)) {
+          return -1;
+        }
+        return static_cast<int>(checked_size);
+      }
+    }  // namespace detail
+
+    /**
+     * @brief Encodes one record as a delimited frame
+     *
+     * @param record The record to send
+     * @param output At least FRAME_MAX_SIZE bytes
+     * @return Number of bytes written, including the delimiter
+     */
+    inline std::size_t encode_frame(const Record& record, uint8_t* output) {
+      uint8_t raw[FRAME_MAX_RAW_SIZE];
+      std::size_t size = record.header.size <= RECORD_PAYLOAD_SIZE
+                             ? record.header.size
+                             : RECORD_PAYLOAD_SIZE;
+      std::memcpy(raw, &record.header, sizeof(RecordHeader));
+      std::memcpy(raw + sizeof(RecordHeader), record.payload, size);
+      return detail::finish_frame(raw, size + sizeof(RecordHeader), output);
+    }
+
+    /**
+     * @brief Decodes one frame back into a record
+     *
+     * @param data Encoded bytes, without the 0x00 delimiter
+     * @param length Number of encoded bytes
+     * @param record Written with the decoded record on success
+     * @return false if the frame is malformed or its CRC does not match
+     */
+    inline bool decode_frame(const uint8_t* data, std::size_t length,
+                             Record& record) {
+      if(length > cobs_max_encoded_size(FRAME_MAX_RAW_SIZE)) {
+        return false;
+      }
+      uint8_t raw[cobs_max_encoded_size(FRAME_MAX_RAW_SIZE)];
+      const int checked_size = detail::open_frame(data, length, raw);
+      if(checked_size < static_cast<int>(sizeof(RecordHeader))) {
+        return false;
+      }
+      std::memcpy(&record.header, raw, sizeof(RecordHeader));
+      const std::size_t payload_size =
+          static_cast<std::size_t>(checked_size) - sizeof(RecordHeader);
+      if(record.header.size != payload_size) {
+        return false;
+      }
+      std::memset(record.payload, 0, RECORD_PAYLOAD_SIZE);
+      std::memcpy(record.payload, raw + sizeof(RecordHeader), payload_size);
+      return true;
+    }
+
+    /**
+     * @brief Encodes a packet of DeltaEncoder output as a delimited frame
+     *
+     * @param packet At most PACKET_MAX_SIZE bytes
+     * @param output At least PACKET_FRAME_MAX_SIZE bytes
+     * @return Number of bytes written, including the delimiter
+     */
+    inline std::size_t encode_packet_frame(const uint8_t* packet,
+                                           std::size_t length,
+                                           uint8_t* output) {
+      uint8_t raw[PACKET_MAX_SIZE + sizeof(uint16_t)];
+      std::memcpy(raw, packet, length);
+      return detail::finish_frame(raw, length, output);
+    }
+
+    /**
+     * @brief Decodes one packet frame
+     *
+     * @param data Encoded bytes, without the 0x00 delimiter
+     * @param packet At least PACKET_FRAME_MAX_SIZE bytes
+     * @param packet_length Written with the packet size on success
+     * @return false if the frame is malformed or its CRC does not match
+     */
+    inline bool decode_packet_frame(const uint8_t* data, std::size_t length,
+                                    uint8_t* packet,
+                                    std::size_t& packet_length) {
+      if(length > PACKET_FRAME_MAX_SIZE - 1) {
+        return false;
+      }
+      const int size = detail::open_frame(data, length, packet);
+      if(size <= 0) {
+        return false;
+      }
+      packet_length = static_cast<std::size_t>(size);
+      return true;
+    }
+  }  // namespace telemetry
+}  // namespace apollo
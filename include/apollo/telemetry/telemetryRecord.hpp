@@ -0,0 +1,268 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Binary telemetry records shared by the brain and the native tools. Nothing
+ * in here depends on PROS, so the same definitions decode logs on a laptop.
+ * Every field is little-endian and naturally aligned, which lets both sides
+ * copy records with memcpy.
+ */
+namespace apollo {
+  namespace telemetry {
+    enum record_channel : uint8_t {
+      CHANNEL_DROPPED = 0,
+      CHANNEL_CHASSIS = 1,
+      CHANNEL_POSE = 2,
+      CHANNEL_CONTROLLER = 3,
+      CHANNEL_CUSTOM = 4,
+      CHANNEL_TRACKER = 5,
+      CHANNEL_BLACK_BOX = 6,
+      CHANNEL_DRIVE_TARGET = 7
+    };
+
+    constexpr std::size_t RECORD_SIZE = 32;
+    constexpr std::size_t RECORD_PAYLOAD_SIZE = 24;
+
+    struct RecordHeader {
+      /**
+       * @brief Microseconds since the program started, wraps every ~71 min
+       *
+       */
+      uint32_t timestamp;
+      uint8_t channel;
+      /**
+       * @brief Bytes of the payload that are in use
+       *
+       */
+      uint8_t size;
+      uint16_t reserved;
+    };
+
+    /**
+     * @brief One fixed-size slot of the log
+     *
+     */
+    struct Record {
+      RecordHeader header;
+      uint8_t payload[RECORD_PAYLOAD_SIZE];
+    };
+    static_assert(sizeof(Record) == RECORD_SIZE, "Record must stay packed");
+
+    /**
+     * @brief Emitted by the writer when records were lost to a full buffer
+     *
+     */
+    struct DroppedRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_DROPPED;
+      uint32_t count;
+    };
+
+    /**
+     * @brief State of a two-sided drivetrain during one control tick
+     *
+     */
+    struct ChassisRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_CHASSIS;
+      /**
+       * @brief Sensored motor positions, in encoder ticks
+       *
+       */
+      float left_position;
+      float right_position;
+      /**
+       * @brief Sensored motor velocities, in RPM
+       *
+       */
+      float left_velocity;
+      float right_velocity;
+      /**
+       * @brief Commanded voltages, in millivolts
+       *
+       */
+      int16_t left_voltage;
+      int16_t right_voltage;
+      /**
+       * @brief Inertial Sensor rotation, in degrees. Clockwise positive and
+       * not wrapped to 360.
+       *
+       */
+      float heading;
+    };
+
+    /**
+     * @brief Tracking wheel positions, in encoder ticks
+     *
+     */
+    struct TrackerRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_TRACKER;
+      float left_position;
+      float right_position;
+      float center_position;
+    };
+
+    /**
+     * @brief Estimated field position, in meters and radians
+     *
+     */
+    struct PoseRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_POSE;
+      float x;
+      float y;
+      float theta;
+    };
+
+    /**
+     * @brief Controller inputs. Bit i of `buttons` is
+     * `pros::E_CONTROLLER_DIGITAL_L1 + i`.
+     *
+     */
+    struct ControllerRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_CONTROLLER;
+      int8_t left_x;
+      int8_t left_y;
+      int8_t right_x;
+      int8_t right_y;
+      uint16_t buttons;
+      uint16_t reserved;
+    };
+
+    /**
+     * @brief Up to five user values, identified by a user-chosen id
+     *
+     */
+    struct CustomRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_CUSTOM;
+      uint16_t id;
+      uint16_t reserved;
+      float values[5];
+    };
+
+    enum black_box_reason : uint16_t {
+      BLACK_BOX_CHECKPOINT = 0,
+      BLACK_BOX_BROWNOUT = 1,
+      BLACK_BOX_TERMINATE = 2,
+      BLACK_BOX_MANUAL = 3
+    };
+
+    /**
+     * @brief First record of a black box dump, saying why it was written
+     *
+     */
+    struct BlackBoxRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_BLACK_BOX;
+      uint16_t reason;
+      uint16_t reserved;
+      /**
+       * @brief Battery voltage when the dump was written, in millivolts
+       *
+       */
+      int32_t battery_voltage;
+      /**
+       * @brief Records lost to overwriting before this dump, since start
+       *
+       */
+      uint32_t overwritten_count;
+    };
+
+    /**
+     * @brief Start or end of a TankModel::drive_distance() move. The chassis
+     * records in between hold what its DriveController commanded.
+     *
+     */
+    struct DriveTargetRecord {
+      static constexpr uint8_t CHANNEL = CHANNEL_DRIVE_TARGET;
+      /**
+       * @brief Distance to drive, in inches
+       *
+       */
+      float distance;
+      /**
+       * @brief Control loop period, in milliseconds
+       *
+       */
+      uint16_t period;
+      /**
+       * @brief 1 when the move starts, 0 when it ends
+       *
+       */
+      uint8_t is_active;
+      uint8_t reserved;
+    };
+
+    static_assert(sizeof(ChassisRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(TrackerRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(PoseRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(ControllerRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(CustomRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(BlackBoxRecord) <= RECORD_PAYLOAD_SIZE);
+    static_assert(sizeof(DriveTargetRecord) <= RECORD_PAYLOAD_SIZE);
+
+    /**
+     * @brief Wraps a payload into a record
+     *
+     * @param payload Any record type with a CHANNEL constant
+     * @param timestamp Microseconds since the program started
+     * @return Record
+     */
+    template <typename Payload>
+    inline Record make_record(const Payload& payload, uint32_t timestamp) {
+      static_assert(sizeof(Payload) <= RECORD_PAYLOAD_SIZE,
+                    "Telemetry payloads must fit into a single record");
+      Record record;
+      record.header.timestamp = timestamp;
+      record.header.channel = Payload::CHANNEL;
+      record.header.size = static_cast<uint8_t>(sizeof(Payload));
+      record.header.reserved = 0;
+      std::memcpy(record.payload, &payload, sizeof(Payload));
+      std::memset(record.payload + sizeof(Payload), 0,
+                  RECORD_PAYLOAD_SIZE - sizeof(Payload));
+      return record;
+    }
+
+    /**
+     * @brief Extracts a payload from a record
+     *
+     * @return false if the record holds a different channel or size
+     */
+    template <typename Payload>
+    inline bool read_record(const Record& record, Payload& payload) {
+      if(record.header.channel != Payload::CHANNEL ||
+         record.header.size != sizeof(Payload)) {
+        return false;
+      }
+      std::memcpy(&payload, record.payload, sizeof(Payload));
+      return true;
+    }
+
+    /**
+     * @brief Written once at the start of every log file
+     *
+     */
+    struct LogFileHeader {
+      char magic[4];
+      uint16_t version;
+      uint16_t record_size;
+    };
+    constexpr char LOG_FILE_MAGIC[4] = {'A', 'P', 'L', 'G'};
+    constexpr uint16_t LOG_FILE_VERSION = 1;
+    /**
+     * @brief Log files of this version hold lossless DeltaEncoder output
+     * instead of fixed-size records
+     *
+     */
+    constexpr uint16_t LOG_FILE_VERSION_DELTA = 2;
+    /**
+     * @brief Log files of this version hold quantized DeltaEncoder output
+     *
+     */
+    constexpr uint16_t LOG_FILE_VERSION_DELTA_QUANTIZED = 3;
+  }  // namespace telemetry
+}  // namespace apollo
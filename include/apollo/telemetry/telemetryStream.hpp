@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "apollo/telemetry/deltaCodec.hpp"
+#include "apollo/telemetry/ringBuffer.hpp"
+#include "apollo/telemetry/streamFrame.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace telemetry {
+    /**
+     * @brief Streams telemetry records over the V5 USB serial port as COBS
+     * frames with a CRC, for live plotting on a laptop.
+     *
+     * Records are queued like TelemetryLogger and written by a low priority
+     * task, which spends at most `byte_budget` bytes per second. Records that
+     * would exceed the budget are dropped instead of delaying later ones.
+     * Decode the stream with `tools/telemetry_decode --stream`.
+     *
+     * Records are delta encoded, with float fields quantized, and packed
+     * several to a frame unless compression is turned off, which fits
+     * several times more records into the same budget. Every channel sends
+     * a keyframe at least every KEYFRAME_INTERVAL records, and after any
+     * dropped packet, so the decoder recovers from lost bytes.
+     *
+     * Starting the stream turns off PROS' own stdout multiplexing and makes
+     * stdout writes non-blocking, so the PROS terminal will show raw bytes
+     * while it runs. stop() puts both back. Plain printf output is still
+     * passed through by the decoder.
+     */
+    class TelemetryStream {
+     public:
+      static constexpr std::size_t BUFFER_CAPACITY = 256;
+      static constexpr std::size_t CHANNEL_COUNT = 8;
+      static constexpr uint16_t KEYFRAME_INTERVAL = 100;
+
+      /**
+       * @brief Construct a new Telemetry Stream
+       *
+       * @param byte_budget Most bytes per second written to the serial port
+       * @param period Milliseconds between writes
+       * @param compressed Send delta encoded packets. Turn off to send every
+       * record in its own frame, decoded with `--raw-stream`.
+       */
+      explicit TelemetryStream(uint32_t byte_budget = 11520,
+                               uint32_t period = 10, bool compressed = true);
+      ~TelemetryStream();
+
+      bool start();
+      void stop();
+      bool is_running() const;
+
+      /**
+       * @brief Only send every `every`-th record of a channel. 1 sends every
+       * record, the default.
+       *
+       */
+      void set_decimation(uint8_t channel, uint16_t every);
+
+      /**
+       * @brief Queues one record. Safe to call from any task, never blocks.
+       *
+       * @param payload Any record type from telemetryRecord.hpp
+       * @return false if the buffer was full and the record was dropped.
+       * Records skipped by decimation still return true.
+       */
+      template <typename Payload>
+      bool log(const Payload& payload) {
+        if(!is_selected(Payload::CHANNEL)) {
+          return true;
+        }
+        if(buffer.push(
+               make_record(payload, static_cast<uint32_t>(pros::micros())))) {
+          return true;
+        }
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      /**
+       * @brief Records lost to a full buffer or to the byte budget
+       *
+       */
+      uint32_t get_dropped_count() const;
+
+     private:
+      static constexpr std::size_t OUTPUT_SIZE = 1024;
+
+      bool is_selected(uint8_t channel);
+      void writer_loop();
+      void send_packet(uint32_t& tokens);
+      void flush();
+
+      RingBuffer<Record, BUFFER_CAPACITY> buffer;
+      std::atomic<uint16_t> decimation[CHANNEL_COUNT];
+      std::atomic<uint16_t> decimation_count[CHANNEL_COUNT];
+      std::atomic<uint32_t> dropped_count{0};
+
+      uint32_t byte_budget;
+      uint32_t period;
+      bool compressed;
+      // Quantized, since the serial budget matters more than exact floats
+      DeltaEncoder encoder{KEYFRAME_INTERVAL, true};
+      pros::Task* writer_task = nullptr;
+      std::atomic<bool> running{false};
+
+      uint8_t output[OUTPUT_SIZE];
+      std::size_t output_length = 0;
+
+      uint8_t packet[PACKET_MAX_SIZE];
+      std::size_t packet_length = 0;
+      uint32_t packet_records = 0;
+    };
+  }  // namespace telemetry
+}  // namespace apollo
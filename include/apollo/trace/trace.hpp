@@ -0,0 +1,99 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/trace/traceFile.hpp"
+
+/**
+ * Records when tasks start and finish pieces of work, to find scheduling
+ * stalls and priority problems.
+ *
+ * Every task that records an event gets its own fixed buffer, so recording
+ * takes no lock and only the task itself writes to it. Buffers keep the
+ * most recent EVENTS_PER_TASK events. dump() writes them to the SD card and
+ * `tools/trace_export` turns the file into Chrome Trace JSON, which
+ * chrome://tracing and ui.perfetto.dev can open.
+ *
+ * Event names are not copied, so pass string literals.
+ *
+ * @code
+ * trace::start();
+ * while(true) {
+ *   {
+ *     trace::TraceScope scope("odometry");
+ *     odometry.update(left, right, heading);
+ *   }
+ *   pros::delay(10);
+ * }
+ * @endcode
+ */
+namespace apollo {
+  namespace trace {
+    /**
+     * @brief Most tasks that can record events. A task keeps its buffer
+     * after it exits, so prefer long-lived tasks for tracing.
+     *
+     */
+    constexpr std::size_t MAX_TASKS = 16;
+    constexpr std::size_t EVENTS_PER_TASK = 1024;
+
+    /**
+     * @brief Starts recording. Events recorded before are kept.
+     *
+     */
+    void start();
+    /**
+     * @brief Stops recording, for example before dump()
+     *
+     */
+    void stop();
+    bool is_recording();
+    /**
+     * @brief Forgets every recorded event. Only call while stopped.
+     *
+     */
+    void clear();
+
+    void begin(const char* name);
+    void end(const char* name);
+    void instant(const char* name);
+
+    /**
+     * @brief Writes every recorded event to a file for tools/trace_export.
+     * Call it after stop(), so no task writes to its buffer during the dump.
+     * Events past the first TRACE_MAX_NAMES distinct names are written
+     * under TRACE_OVERFLOW_NAME and counted in the header.
+     *
+     * @return false if the file can't be written
+     */
+    bool dump(const char* path = "/usd/apollo_trace.bin");
+
+    /**
+     * @brief Events lost because all MAX_TASKS buffers were taken
+     *
+     */
+    uint32_t get_dropped_count();
+
+    /**
+     * @brief Records a begin event now and the matching end event when it
+     * goes out of scope
+     *
+     */
+    class TraceScope {
+     public:
+      explicit TraceScope(const char* name) : name(name) { begin(name); }
+      ~TraceScope() { end(name); }
+      TraceScope(const TraceScope&) = delete;
+      TraceScope& operator=(const TraceScope&) = delete;
+
+     private:
+      const char* name;
+    };
+  }  // namespace trace
+}  // namespace apollo
@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Layout of the files written by trace::dump(), shared with the native
+ * exporter. A file is a TraceFileHeader, `task_count` task names,
+ * `name_count` event names and `event_count` TraceFileEvents, in that order.
+ * Events of one task are in the order they were recorded.
+ */
+namespace apollo {
+  namespace trace {
+    enum trace_event_type : uint8_t {
+      TRACE_BEGIN = 'B',
+      TRACE_END = 'E',
+      TRACE_INSTANT = 'i'
+    };
+
+    constexpr std::size_t TRACE_NAME_SIZE = 32;
+    constexpr char TRACE_FILE_MAGIC[4] = {'A', 'P', 'T', 'R'};
+    constexpr uint16_t TRACE_FILE_VERSION = 1;
+    /**
+     * @brief Most distinct event names one file holds
+     *
+     */
+    constexpr std::size_t TRACE_MAX_NAMES = 256;
+    /**
+     * @brief Name index of events recorded after the name table was full.
+     * It is not an index into the names.
+     *
+     */
+    constexpr uint16_t TRACE_OVERFLOW_NAME = 0xFFFF;
+
+    struct TraceFileHeader {
+      char magic[4];
+      uint16_t version;
+      uint16_t task_count;
+      uint16_t name_count;
+      /**
+       * @brief Events written with TRACE_OVERFLOW_NAME because their name
+       * did not fit in the name table. Zero in files from before it was
+       * counted, when this field was reserved.
+       *
+       */
+      uint16_t overflow_count;
+      /**
+       * @brief Events lost because every task slot was taken
+       *
+       */
+      uint32_t dropped_count;
+      uint32_t event_count;
+    };
+
+    /**
+     * @brief A task or event name, null terminated
+     *
+     */
+    struct TraceFileName {
+      char name[TRACE_NAME_SIZE];
+    };
+
+    struct TraceFileEvent {
+      /**
+       * @brief pros::micros() when the event was recorded
+       *
+       */
+      uint32_t timestamp;
+      /**
+       * @brief Index into the event names, or TRACE_OVERFLOW_NAME
+       *
+       */
+      uint16_t name;
+      uint8_t type;
+      /**
+       * @brief Index into the task names
+       *
+       */
+      uint8_t task;
+    };
+    static_assert(sizeof(TraceFileEvent) == 8, "TraceFileEvent must stay packed");
+  }  // namespace trace
+}  // namespace apollo
@@ -0,0 +1,83 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "apollo/tuning/parameterRegistry.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  /**
+   * @brief Edits a ParameterRegistry while the program runs, from the PROS
+   * terminal and from the LLEMU buttons.
+   *
+   * Serial commands, one per line:
+   * - `list` prints every parameter
+   * - `get NAME` prints one parameter
+   * - `set NAME VALUE` changes one parameter, in its display units
+   * - `reset NAME` restores a parameter's default
+   * - `save` and `load` write and read the parameter file
+   *
+   * On the LLEMU, the center button selects the next parameter and the left
+   * and right buttons step it down and up. Changes made on the LLEMU are
+   * saved when another parameter is selected.
+   *
+   * Both run in low priority tasks and only ever touch the registry, so
+   * control loops are not slowed down. The serial console reads stdin, so
+   * don't run it while TelemetryStream is streaming.
+   */
+  class ParameterConsole {
+   public:
+    /**
+     * @brief Construct a new Parameter Console
+     *
+     * @param registry Parameters to edit, must outlive the console
+     * @param path File used by `save`, `load` and LLEMU changes
+     */
+    explicit ParameterConsole(ParameterRegistry& registry,
+                              const char* path = "/usd/apollo_params.txt");
+    ~ParameterConsole();
+
+    /**
+     * @brief Starts the console tasks. Call after pros::lcd::initialize() to
+     * use the LLEMU. The LLEMU and brain_gui both draw on the brain screen,
+     * so leave `lcd` off while the GUI runs and use gui::TuningPanel
+     * instead.
+     *
+     * The LLEMU needs the liblvgl template, which this project does not
+     * ship. Without it, or before pros::lcd::initialize(), the LLEMU task is
+     * not started.
+     *
+     * @param serial Accept commands on the serial terminal
+     * @param lcd Show and edit parameters on the LLEMU
+     * @return false if `lcd` was asked for but the LLEMU is not available
+     */
+    bool start(bool serial = true, bool lcd = false);
+
+    /**
+     * @brief Runs one serial command
+     *
+     * @param line The command, without its line ending
+     * @return false if the command was not understood
+     */
+    bool run_command(char* line);
+
+   private:
+    void serial_loop();
+    void lcd_loop();
+    void draw_lcd();
+    void print_parameter(std::size_t index);
+
+    ParameterRegistry& registry;
+    const char* path;
+    pros::Task* serial_task = nullptr;
+    pros::Task* lcd_task = nullptr;
+    std::atomic<bool> running{false};
+    std::size_t selected = 0;
+  };
+}  // namespace apollo
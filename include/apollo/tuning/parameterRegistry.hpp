@@ -0,0 +1,234 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "apollo/units/RQuantity.hpp"
+
+namespace apollo {
+  enum parameter_type { PARAMETER_DOUBLE, PARAMETER_INT, PARAMETER_BOOL };
+
+  /**
+   * @brief One slot of the parameter table. Values are stored in SI units;
+   * `unit` converts them to the units shown to and typed by the user.
+   *
+   */
+  struct ParameterEntry {
+    const char* name = nullptr;
+    parameter_type type = PARAMETER_DOUBLE;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    /**
+     * @brief Change per LLEMU button press, in display units
+     *
+     */
+    double step = 0.0;
+    double unit = 1.0;
+    const char* suffix = nullptr;
+    double default_value = 0.0;
+    std::atomic<double> value{0.0};
+  };
+
+  namespace detail {
+    inline double to_parameter_storage(double value) { return value; }
+    inline double to_parameter_storage(int value) { return value; }
+    inline double to_parameter_storage(bool value) { return value ? 1.0 : 0.0; }
+    template <typename M, typename L, typename T, typename A>
+    double to_parameter_storage(units::RQuantity<M, L, T, A> value) {
+      return value.getValue();
+    }
+
+    template <typename T>
+    struct ParameterStorage {
+      static T from(double value) { return T(value); }
+    };
+    template <>
+    struct ParameterStorage<int> {
+      static int from(double value) { return static_cast<int>(value); }
+    };
+    template <>
+    struct ParameterStorage<bool> {
+      static bool from(double value) { return value != 0.0; }
+    };
+  }  // namespace detail
+
+  /**
+   * @brief Typed handle to a registered parameter. Reading it is a single
+   * relaxed atomic load, so it is meant to be kept and read every tick
+   * instead of looking the parameter up by name.
+   *
+   * @tparam T double, int, bool or an RQuantity type
+   */
+  template <typename T>
+  class Parameter {
+   public:
+    Parameter(const std::atomic<double>* value, T fallback)
+        : value(value), fallback(fallback) {}
+
+    /**
+     * @brief Current value, or the default if the parameter could not be
+     * registered
+     *
+     */
+    T get() const {
+      return value != nullptr ? detail::ParameterStorage<T>::from(
+                                    value->load(std::memory_order_relaxed))
+                              : fallback;
+    }
+    operator T() const { return get(); }
+
+    /**
+     * @brief false if the registry was full or the name was taken
+     *
+     */
+    bool is_registered() const { return value != nullptr; }
+
+   private:
+    const std::atomic<double>* value;
+    T fallback;
+  };
+
+  /**
+   * @brief Flat table of named, typed parameters that can be changed while
+   * the program runs.
+   *
+   * Parameters are registered once during initialization and read through
+   * the returned handles. ParameterConsole edits them over the serial
+   * terminal or the LLEMU buttons, and save()/load() keep them on the SD card
+   * as `name value` lines in display units.
+   *
+   * @code
+   * ParameterRegistry parameters;
+   * Parameter<double> kP = parameters.add("drive.kP", 0.5, 0.0, 5.0, 0.05);
+   * Parameter<units::QLength> tolerance = parameters.add(
+   *     "drive.tolerance", 1.0 * inch, 0.0 * inch, 6.0 * inch, 0.25 * inch,
+   *     inch, "in");
+   * parameters.load("/usd/apollo_params.txt");
+   * @endcode
+   */
+  class ParameterRegistry {
+   public:
+    static constexpr std::size_t MAX_PARAMETERS = 64;
+    /**
+     * @brief Largest file load() reads
+     *
+     */
+    static constexpr std::size_t MAX_FILE_SIZE = 4096;
+
+    ParameterRegistry() = default;
+    ParameterRegistry(const ParameterRegistry&) = delete;
+    ParameterRegistry& operator=(const ParameterRegistry&) = delete;
+
+    /**
+     * @brief Registers a parameter. `name` is not copied and must outlive
+     * the registry, which a string literal does.
+     *
+     * @param step Change per LLEMU button press. 0 uses a hundredth of the
+     * range.
+     * @return A handle that reads the default value if registration failed
+     */
+    Parameter<double> add(const char* name, double default_value,
+                          double minimum, double maximum, double step = 0.0);
+    Parameter<int> add(const char* name, int default_value, int minimum,
+                       int maximum, int step = 1);
+    Parameter<bool> add(const char* name, bool default_value);
+
+    /**
+     * @brief Registers a quantity. It is shown, typed and saved in
+     * multiples of `unit`.
+     *
+     * @param suffix Shown after the value, or nullptr for none
+     */
+    template <typename M, typename L, typename T, typename A>
+    Parameter<units::RQuantity<M, L, T, A>> add(
+        const char* name, units::RQuantity<M, L, T, A> default_value,
+        units::RQuantity<M, L, T, A> minimum,
+        units::RQuantity<M, L, T, A> maximum,
+        units::RQuantity<M, L, T, A> step, units::RQuantity<M, L, T, A> unit,
+        const char* suffix = nullptr) {
+      ParameterEntry* entry = add_entry(
+          name, PARAMETER_DOUBLE, detail::to_parameter_storage(default_value),
+          minimum.getValue(), maximum.getValue(), step.convert(unit),
+          unit.getValue(), suffix);
+      return {entry != nullptr ? &entry->value : nullptr, default_value};
+    }
+
+    std::size_t size() const;
+    const ParameterEntry& get_entry(std::size_t index) const;
+    /**
+     * @brief Index of the parameter called `name`, or -1. Meant for
+     * consoles, not control loops.
+     *
+     */
+    int find(const char* name) const;
+
+    /**
+     * @brief Value of a parameter in display units
+     *
+     */
+    double get_value(std::size_t index) const;
+    /**
+     * @brief Changes a parameter. The value is clamped to the parameter's
+     * range and rounded for int and bool parameters.
+     *
+     * @param value New value in display units
+     * @return false if there is no parameter at `index`
+     */
+    bool set_value(std::size_t index, double value);
+    /**
+     * @brief Moves a parameter by `steps` of its step size
+     *
+     */
+    bool step_value(std::size_t index, int steps);
+    bool reset_value(std::size_t index);
+
+    /**
+     * @brief Writes a parameter's value and suffix into `buffer`
+     *
+     * @return The number of characters written, excluding the terminator
+     */
+    int format_value(std::size_t index, char* buffer, std::size_t size) const;
+
+    /**
+     * @brief Writes every parameter as a `name value` line
+     *
+     * @return false if the file can't be written
+     */
+    bool save(const char* path) const;
+    /**
+     * @brief Reads a file written by save() with a single read. Unknown
+     * names and malformed lines are skipped. Only the first MAX_FILE_SIZE
+     * bytes are read; a line cut off there is skipped and is_truncated()
+     * reports it.
+     *
+     * @return false if the file can't be read
+     */
+    bool load(const char* path);
+    /**
+     * @brief true if the file last loaded was longer than MAX_FILE_SIZE
+     *
+     */
+    bool is_truncated() const;
+    /**
+     * @brief Applies `name value` lines from memory, as load() does
+     *
+     * @return Number of parameters set
+     */
+    int parse(const char* text, std::size_t length);
+
+   private:
+    ParameterEntry* add_entry(const char* name, parameter_type type,
+                              double default_value, double minimum,
+                              double maximum, double step, double unit,
+                              const char* suffix);
+
+    ParameterEntry entries[MAX_PARAMETERS];
+    std::size_t count = 0;
+    bool truncated = false;
+  };
+}  // namespace apollo
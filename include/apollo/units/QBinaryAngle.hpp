@@ -0,0 +1,113 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "apollo/units/QAngle.hpp"
+#include "apollo/units/RQuantity.hpp"
+
+namespace apollo {
+  namespace units {
+    /**
+     * @brief A heading stored as a 32-bit binary angle, where the full
+     * integer range maps onto one revolution.
+     *
+     * Unsigned overflow does the wrapping, so addition, subtraction and the
+     * shortest difference between two headings are plain integer operations
+     * with no std::fmod and no branches. Resolution is about 1.5e-9 rad.
+     *
+     * @code
+     * BinaryAngle heading(imu.get_heading() * degree);
+     * QAngle error = heading.shortest_difference(BinaryAngle(90_deg));
+     * @endcode
+     */
+    class BinaryAngle {
+     public:
+      constexpr BinaryAngle() : value(0) {}
+      /**
+       * @brief Construct from any angle, wrapping it into one revolution.
+       * Accurate for angles up to a few billion radians.
+       *
+       */
+      explicit constexpr BinaryAngle(QAngle angle)
+          : value(from_radians(angle.getValue())) {}
+
+      /**
+       * @brief Construct directly from the 32-bit representation
+       *
+       */
+      static constexpr BinaryAngle from_raw(uint32_t raw) {
+        BinaryAngle angle;
+        angle.value = raw;
+        return angle;
+      }
+      constexpr uint32_t get_raw() const { return value; }
+
+      /**
+       * @brief The angle wrapped into [-180, 180) degrees
+       *
+       * @return QAngle
+       */
+      constexpr QAngle get_angle() const {
+        return QAngle(static_cast<int32_t>(value) * RADIAN_PER_LSB);
+      }
+      /**
+       * @brief The angle wrapped into [0, 360) degrees
+       *
+       * @return QAngle
+       */
+      constexpr QAngle get_unsigned_angle() const {
+        return QAngle(value * RADIAN_PER_LSB);
+      }
+      /**
+       * @brief Signed shortest rotation that takes this angle onto `target`,
+       * in [-180, 180) degrees. Positive values are counter-clockwise.
+       *
+       * @return QAngle
+       */
+      constexpr QAngle shortest_difference(BinaryAngle target) const {
+        return (target - *this).get_angle();
+      }
+
+      constexpr BinaryAngle& operator+=(BinaryAngle rhs) {
+        value += rhs.value;
+        return *this;
+      }
+      constexpr BinaryAngle& operator-=(BinaryAngle rhs) {
+        value -= rhs.value;
+        return *this;
+      }
+      constexpr BinaryAngle operator-() const { return from_raw(0u - value); }
+      friend constexpr BinaryAngle operator+(BinaryAngle lhs, BinaryAngle rhs) {
+        return from_raw(lhs.value + rhs.value);
+      }
+      friend constexpr BinaryAngle operator-(BinaryAngle lhs, BinaryAngle rhs) {
+        return from_raw(lhs.value - rhs.value);
+      }
+      friend constexpr bool operator==(BinaryAngle lhs, BinaryAngle rhs) {
+        return lhs.value == rhs.value;
+      }
+      friend constexpr bool operator!=(BinaryAngle lhs, BinaryAngle rhs) {
+        return lhs.value != rhs.value;
+      }
+
+     private:
+      static constexpr double LSB_PER_RADIAN = 4294967296.0 / (2_pi);
+      static constexpr double RADIAN_PER_LSB = (2_pi) / 4294967296.0;
+
+      static constexpr uint32_t from_radians(double radians) {
+        // Rounds to the nearest step, then the int64 to uint32 conversion
+        // discards whole revolutions
+        const double scaled = radians * LSB_PER_RADIAN;
+        return static_cast<uint32_t>(
+            static_cast<int64_t>(scaled + (scaled < 0.0 ? -0.5 : 0.5)));
+      }
+
+      uint32_t value;
+    };
+  }  // namespace units
+}  // namespace apollo
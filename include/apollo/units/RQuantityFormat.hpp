@@ -0,0 +1,297 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/units/QAngle.hpp"
+#include "apollo/units/QAngularSpeed.hpp"
+#include "apollo/units/QLength.hpp"
+#include "apollo/units/QSpeed.hpp"
+#include "apollo/units/QTime.hpp"
+#include "apollo/units/RQuantity.hpp"
+
+namespace apollo {
+  namespace units {
+    namespace detail {
+      constexpr uint64_t format_power_of_ten[] = {
+          1,      10,      100,      1000,      10000,
+          100000, 1000000, 10000000, 100000000, 1000000000};
+      constexpr int FORMAT_MAX_PRECISION = 9;
+
+      /**
+       * @brief Appends characters to a caller-provided buffer, silently
+       * dropping whatever does not fit. The buffer is always null terminated.
+       *
+       */
+      class FormatWriter {
+       public:
+        FormatWriter(char* buffer, std::size_t size)
+            : buffer(buffer), size(size) {
+          if(size > 0) {
+            buffer[0] = '\0';
+          }
+        }
+        void put(char c) {
+          if(length + 1 < size) {
+            buffer[length++] = c;
+            buffer[length] = '\0';
+          }
+        }
+        void put(const char* text) {
+          while(*text != '\0') {
+            put(*text++);
+          }
+        }
+        int get_length() const { return static_cast<int>(length); }
+
+       private:
+        char* buffer;
+        std::size_t size;
+        std::size_t length = 0;
+      };
+
+      inline void format_fixed(FormatWriter& writer, double value,
+                               int precision) {
+        if(value != value) {
+          writer.put("nan");
+          return;
+        }
+        if(precision < 0) {
+          precision = 0;
+        } else if(precision > FORMAT_MAX_PRECISION) {
+          precision = FORMAT_MAX_PRECISION;
+        }
+        const bool is_negative = value < 0.0;
+        if(is_negative) {
+          value = -value;
+        }
+        // Largest magnitude that still fits the integer part in 64 bits
+        if(value >= 1.8e19 / format_power_of_ten[precision]) {
+          writer.put(is_negative ? "-inf" : "inf");
+          return;
+        }
+        const uint64_t scale = format_power_of_ten[precision];
+        const uint64_t scaled =
+            static_cast<uint64_t>(value * static_cast<double>(scale) + 0.5);
+        // Values that round to zero are written without a sign
+        if(is_negative && scaled != 0) {
+          writer.put('-');
+        }
+        uint64_t whole = scaled / scale;
+        uint64_t fraction = scaled % scale;
+
+        char digits[20];
+        int count = 0;
+        do {
+          digits[count++] = static_cast<char>('0' + whole % 10);
+          whole /= 10;
+        } while(whole != 0);
+        while(count > 0) {
+          writer.put(digits[--count]);
+        }
+        if(precision == 0) {
+          return;
+        }
+        writer.put('.');
+        for(int i = precision - 1; i >= 0; i--) {
+          const uint64_t digit = fraction / format_power_of_ten[i];
+          writer.put(static_cast<char>('0' + digit));
+          fraction -= digit * format_power_of_ten[i];
+        }
+      }
+    }  // namespace detail
+
+    /**
+     * Non-throwing counterpart to getShortUnitName for the units used in
+     * telemetry. Returns nullptr when `unit` has no known short name.
+     *
+     * @param unit The unit, for example `inch` or `1_in`
+     * @return The short suffix for that unit, e.g. "in"
+     */
+    inline const char* get_unit_suffix(QLength unit) {
+      const double value = unit.getValue();
+      if(value == meter.getValue()) return "m";
+      if(value == centimeter.getValue()) return "cm";
+      if(value == millimeter.getValue()) return "mm";
+      if(value == inch.getValue()) return "in";
+      if(value == foot.getValue()) return "ft";
+      if(value == tile.getValue()) return "tile";
+      return nullptr;
+    }
+    inline const char* get_unit_suffix(QAngle unit) {
+      const double value = unit.getValue();
+      if(value == degree.getValue()) return "deg";
+      if(value == radian.getValue()) return "rad";
+      return nullptr;
+    }
+    inline const char* get_unit_suffix(QSpeed unit) {
+      const double value = unit.getValue();
+      if(value == mps.getValue()) return "m/s";
+      if(value == (inch / second).getValue()) return "in/s";
+      return nullptr;
+    }
+    inline const char* get_unit_suffix(QAngularSpeed unit) {
+      const double value = unit.getValue();
+      if(value == rpm.getValue()) return "rpm";
+      if(value == radps.getValue()) return "rad/s";
+      if(value == (degree / second).getValue()) return "deg/s";
+      return nullptr;
+    }
+    inline const char* get_unit_suffix(QTime unit) {
+      const double value = unit.getValue();
+      if(value == second.getValue()) return "s";
+      if(value == millisecond.getValue()) return "ms";
+      return nullptr;
+    }
+    /**
+     * Fallback for quantities without a list of known units, such as
+     * QAcceleration. Always nullptr, so format() writes the number with no
+     * suffix; pass one explicitly to label these.
+     *
+     */
+    template <typename M, typename L, typename T, typename A>
+    const char* get_unit_suffix(RQuantity<M, L, T, A>) {
+      return nullptr;
+    }
+
+    /**
+     * Writes a plain number with a fixed number of decimals into `buffer`.
+     * Never allocates, never throws and ignores the locale. Output that does
+     * not fit is truncated and the buffer is always null terminated.
+     *
+     * @param buffer Destination buffer
+     * @param size Size of the destination buffer in bytes
+     * @param value The number to write
+     * @param precision Digits after the decimal point, clamped to [0, 9]
+     * @return The number of characters written, excluding the terminator
+     */
+    inline int format(char* buffer, std::size_t size, double value,
+                      int precision = 2) {
+      detail::FormatWriter writer(buffer, size);
+      detail::format_fixed(writer, value, precision);
+      return writer.get_length();
+    }
+
+    /**
+     * Writes `quantity` expressed in multiples of `unit` into `buffer`,
+     * followed by a space and `suffix` when one is given.
+     * For example: `format(buf, sizeof(buf), 3_ft, inch, "in", 1)` writes
+     * "36.0 in".
+     *
+     * @param buffer Destination buffer
+     * @param size Size of the destination buffer in bytes
+     * @param quantity The quantity to write
+     * @param unit The unit to express the quantity in
+     * @param suffix Text appended after the number, or nullptr for none
+     * @param precision Digits after the decimal point, clamped to [0, 9]
+     * @return The number of characters written, excluding the terminator
+     */
+    template <typename M, typename L, typename T, typename A>
+    int format(char* buffer, std::size_t size,
+               const RQuantity<M, L, T, A>& quantity,
+               const RQuantity<M, L, T, A>& unit, const char* suffix,
+               int precision = 2) {
+      detail::FormatWriter writer(buffer, size);
+      detail::format_fixed(writer, quantity.convert(unit), precision);
+      if(suffix != nullptr) {
+        writer.put(' ');
+        writer.put(suffix);
+      }
+      return writer.get_length();
+    }
+
+    /**
+     * Same as above, with the suffix looked up through get_unit_suffix.
+     * For example: `format(buf, sizeof(buf), 90_deg, radian)` writes
+     * "1.57 rad".
+     */
+    template <typename M, typename L, typename T, typename A>
+    int format(char* buffer, std::size_t size,
+               const RQuantity<M, L, T, A>& quantity,
+               const RQuantity<M, L, T, A>& unit, int precision = 2) {
+      return format(buffer, size, quantity, unit, get_unit_suffix(unit),
+                    precision);
+    }
+
+    /**
+     * Reads a plain number such as "-12.5", "3", "1e-3" or "inf" from the
+     * start of `text`. The counterpart to format(): it ignores the locale,
+     * so '.' is always the decimal point, and it never allocates.
+     *
+     * @param text Text starting with the number
+     * @param value Written with the number when one is read
+     * @return The number of characters read, or 0 if `text` does not start
+     * with a number
+     */
+    inline int parse(const char* text, double& value) {
+      const char* cursor = text;
+      const bool is_negative = *cursor == '-';
+      if(*cursor == '-' || *cursor == '+') {
+        cursor++;
+      }
+      if(cursor[0] == 'i' && cursor[1] == 'n' && cursor[2] == 'f') {
+        value = is_negative ? -INFINITY : INFINITY;
+        return static_cast<int>(cursor + 3 - text);
+      }
+      // Digits past what fits in 64 bits only move the decimal point
+      uint64_t mantissa = 0;
+      int exponent = 0;
+      bool has_digits = false;
+      for(; *cursor >= '0' && *cursor <= '9'; cursor++) {
+        has_digits = true;
+        if(mantissa < UINT64_MAX / 10 - 9) {
+          mantissa = mantissa * 10 + (*cursor - '0');
+        } else {
+          exponent++;
+        }
+      }
+      if(*cursor == '.') {
+        cursor++;
+        for(; *cursor >= '0' && *cursor <= '9'; cursor++) {
+          has_digits = true;
+          if(mantissa < UINT64_MAX / 10 - 9) {
+            mantissa = mantissa * 10 + (*cursor - '0');
+            exponent--;
+          }
+        }
+      }
+      if(!has_digits) {
+        return 0;
+      }
+      // The exponent only counts if it has digits, so "2e" reads as 2
+      if(*cursor == 'e' || *cursor == 'E') {
+        const char* digits = cursor + 1;
+        const bool is_exponent_negative = *digits == '-';
+        if(*digits == '-' || *digits == '+') {
+          digits++;
+        }
+        if(*digits >= '0' && *digits <= '9') {
+          int written = 0;
+          for(; *digits >= '0' && *digits <= '9'; digits++) {
+            if(written < 10000) {
+              written = written * 10 + (*digits - '0');
+            }
+          }
+          exponent += is_exponent_negative ? -written : written;
+          cursor = digits;
+        }
+      }
+      // Dividing by an exact power of ten rounds once, where multiplying by
+      // its inexact inverse would round twice
+      double result = static_cast<double>(mantissa);
+      if(exponent < 0) {
+        result /= std::pow(10.0, -exponent);
+      } else if(exponent > 0) {
+        result *= std::pow(10.0, exponent);
+      }
+      value = is_negative ? -result : result;
+      return static_cast<int>(cursor - text);
+    }
+  }  // namespace units
+}  // namespace apollo
@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace util {
+    /**
+     * @brief Loads something during boot, like a config file
+     *
+     * @return false if it failed
+     */
+    using BootStep = bool (*)(void* context);
+
+    /**
+     * @brief Runs the slow parts of boot without blocking initialize().
+     *
+     * pros::Imu::reset() blocks for about two seconds while the IMU
+     * calibrates, and reading configs from the SD card adds to that when
+     * done one after the other. start() hands boot to its own task, which
+     * begins calibrating every IMU without waiting for it, runs the load
+     * steps while the IMUs calibrate, and finally waits for calibration to
+     * finish. Boot takes as long as the slower of the two instead of their
+     * sum, and initialize() returns right away so the GUI and
+     * competition_initialize() can run meanwhile.
+     *
+     * autonomous() calls wait_until_ready(), which returns at once if boot
+     * is done and otherwise waits for the rest of it.
+     *
+     * @code
+     * void initialize() {
+     *   boot_pipeline.add_imu(chassis.inertial_sensor.get_port());
+     *   boot_pipeline.add_step(
+     *       "parameters",
+     *       [](void* tuning) {
+     *         return static_cast<gui::TuningPanel*>(tuning)->load();
+     *       },
+     *       &tuning);
+     *   boot_pipeline.start();
+     * }
+     * void autonomous() {
+     *   boot_pipeline.wait_until_ready();
+     *   brain_gui.run_selected_auton();
+     * }
+     * @endcode
+     */
+    class BootPipeline {
+     public:
+      static constexpr std::size_t MAX_IMUS = 4;
+      static constexpr std::size_t MAX_STEPS = 8;
+
+      /**
+       * @brief Construct a new Boot Pipeline
+       *
+       * @param calibration_timeout Milliseconds after start() an IMU may
+       * take to calibrate before it is reported as failed
+       */
+      explicit BootPipeline(uint32_t calibration_timeout = 3000);
+      ~BootPipeline();
+
+      /**
+       * @brief Calibrates the IMU on `port` during boot. Call before start().
+       *
+       * @return false if MAX_IMUS IMUs are added
+       */
+      bool add_imu(uint8_t port);
+      /**
+       * @brief Runs `step` during boot. Steps run one after the other, in
+       * the order added, while the IMUs calibrate. Call before start().
+       *
+       * @param name Must outlive the pipeline, which a string literal does
+       * @return false if MAX_STEPS steps are added
+       */
+      bool add_step(const char* name, BootStep step, void* context = nullptr);
+
+      /**
+       * @brief Starts boot and returns without waiting for it
+       *
+       */
+      void start();
+
+      bool is_ready() const;
+      /**
+       * @brief Waits until boot is done
+       *
+       * @param timeout Longest wait in milliseconds
+       * @return false if boot was not done within `timeout`
+       */
+      bool wait_until_ready(uint32_t timeout = TIMEOUT_MAX);
+
+      /**
+       * @brief false if an IMU could not be reset, reported an error or
+       * did not finish calibrating in time. Only meaningful once ready.
+       *
+       */
+      bool is_imu_calibrated() const;
+      /**
+       * @brief false if any step failed. Only meaningful once ready.
+       *
+       */
+      bool is_loaded() const;
+      std::size_t get_step_count() const;
+      const char* get_step_name(std::size_t index) const;
+      /**
+       * @brief Only meaningful once ready
+       *
+       */
+      bool get_step_result(std::size_t index) const;
+      /**
+       * @brief Milliseconds a step took. Only meaningful once ready.
+       *
+       */
+      uint32_t get_step_time(std::size_t index) const;
+      /**
+       * @brief Milliseconds from start() until ready, or 0 while booting
+       *
+       */
+      uint32_t get_boot_time() const;
+
+     private:
+      struct Step {
+        const char* name;
+        BootStep function;
+        void* context;
+        bool result;
+        uint32_t time;
+      };
+
+      void boot();
+      void reset_imus();
+      bool wait_for_calibration();
+
+      uint8_t imu_ports[MAX_IMUS];
+      /**
+       * @brief false if imu_reset() failed, so the IMU never started
+       * calibrating
+       *
+       */
+      bool is_imu_reset[MAX_IMUS] = {};
+      std::size_t imu_count = 0;
+      Step steps[MAX_STEPS];
+      std::size_t step_count = 0;
+      uint32_t calibration_timeout;
+
+      pros::Task* boot_task = nullptr;
+      std::atomic<bool> started{false};
+      // Released once everything below is written
+      std::atomic<bool> ready{false};
+      uint32_t start_time = 0;
+      uint32_t boot_time = 0;
+      bool imu_calibrated = false;
+      bool loaded = false;
+    };
+  }  // namespace util
+}  // namespace apollo
+
+extern apollo::util::BootPipeline boot_pipeline;
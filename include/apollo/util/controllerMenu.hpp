@@ -0,0 +1,246 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/util/controllerOutput.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace util {
+    /**
+     * @brief Runs when an action item is selected
+     *
+     */
+    using MenuCallback = void (*)(void* context);
+    /**
+     * @brief Writes the value shown at the right of an item
+     *
+     */
+    using MenuText = void (*)(void* context, char* text, std::size_t size);
+    /**
+     * @brief Changes an item's value. `direction` is -1 for left, 1 for
+     * right or A.
+     *
+     */
+    using MenuAdjust = void (*)(void* context, int direction);
+
+    /**
+     * @brief One screen of a ControllerMenu: a list of named items
+     *
+     */
+    class MenuPage {
+     public:
+      static constexpr std::size_t MAX_ITEMS = 16;
+
+      /**
+       * @brief Runs `action` when the item is selected with A or right
+       *
+       * @param name Must outlive the page, which a string literal does. The
+       * same goes for every name and option below.
+       * @return false if the page is full
+       */
+      bool add_action(const char* name, MenuCallback action,
+                      void* context = nullptr);
+      /**
+       * @brief Shows `on` or `off`. Left, right and A flip it.
+       *
+       */
+      bool add_toggle(const char* name, std::atomic<bool>& value);
+      /**
+       * @brief Shows the selected option. Left and right step through the
+       * options, A moves to the next one.
+       *
+       */
+      bool add_choice(const char* name, const char* const* options,
+                      std::size_t option_count, std::atomic<int>& selected);
+      /**
+       * @brief Shows a value that is read again on every refresh, like a
+       * telemetry reading. It can't be changed.
+       *
+       */
+      bool add_value(const char* name, MenuText text, void* context = nullptr);
+      /**
+       * @brief An item with its own text and adjustment, for values that
+       * live elsewhere
+       *
+       * @param adjust nullptr for a read-only item
+       */
+      bool add_item(const char* name, MenuText text, MenuAdjust adjust,
+                    void* context = nullptr);
+      /**
+       * @brief Opens `page` with A or right. B goes back.
+       *
+       */
+      bool add_submenu(const char* name, MenuPage& page);
+
+     private:
+      friend class ControllerMenu;
+
+      enum menu_item_type : uint8_t {
+        MENU_ACTION,
+        MENU_TOGGLE,
+        MENU_CHOICE,
+        MENU_ITEM,
+        MENU_SUBMENU
+      };
+
+      struct Item {
+        menu_item_type type;
+        const char* name;
+        /**
+         * @brief The callbacks' context, the toggle's or choice's atomic,
+         * or the submenu's page
+         *
+         */
+        void* context;
+        MenuCallback action;
+        MenuText text;
+        MenuAdjust adjust;
+        const char* const* options;
+        std::size_t option_count;
+      };
+
+      bool add(const Item& item);
+
+      Item items[MAX_ITEMS];
+      std::size_t item_count = 0;
+    };
+
+    /**
+     * @brief Menu on the controller's three line screen, for pit work when
+     * the brain's touchscreen can't be reached.
+     *
+     * Up and down move the cursor, left and right change the item under it,
+     * A selects and B goes back to the previous page. Buttons are read as
+     * levels with the menu's own edge detection, so the menu never takes a
+     * new press away from code using get_digital_new_press().
+     *
+     * Every period the menu builds its three lines and hands them to a
+     * ControllerOutput, which sends only the characters that differ from
+     * what the controller shows. A telemetry value ticking over costs a few
+     * characters on the radio, not a full redraw, and anything else written
+     * to those lines is put right on the next period.
+     *
+     * The menu starts disabled, so A and the D-pad belong to the driver
+     * until set_enabled(true). Even when enabled it stands down while a
+     * competition switch or field controller has the robot enabled, so a
+     * mechanism bound to A can't run menu actions mid-match.
+     *
+     * @code
+     * std::atomic<bool> is_arcade{false};
+     * util::MenuPage root;
+     * util::MenuPage telemetry;
+     * telemetry.add_value("Battery", [](void*, char* text, std::size_t size) {
+     *   std::snprintf(text, size, "%.0f%%", pros::battery::get_capacity());
+     * });
+     * root.add_item(
+     *     "Auton",
+     *     [](void*, char* text, std::size_t size) {
+     *       const auton* routine = brain_gui.get_selected_auton();
+     *       std::snprintf(text, size, "%s", routine ? routine->name : "-");
+     *     },
+     *     [](void*, int direction) {
+     *       const int count = brain_gui.get_auton_count();
+     *       if(count > 0) {
+     *         const int index =
+     *             (brain_gui.get_selected_auton_index() + direction + count) %
+     *             count;
+     *         brain_gui.post_auton_selection(index, brain_gui.get_field_side());
+     *       }
+     *     });
+     * root.add_toggle("Arcade", is_arcade);
+     * root.add_submenu("Telemetry", telemetry);
+     * util::ControllerMenu menu(master, master_output);
+     * menu.set_root(root);
+     * menu.set_enabled(true);
+     * menu.start();
+     * @endcode
+     */
+    class ControllerMenu {
+     public:
+      static constexpr std::size_t MAX_DEPTH = 4;
+
+      /**
+       * @brief Construct a new Controller Menu
+       *
+       * @param controller Controller whose buttons navigate the menu
+       * @param output Output to the same controller. The menu uses all three
+       * lines while it is enabled.
+       * @param period Milliseconds between button reads and refreshes
+       */
+      ControllerMenu(pros::Controller& controller, ControllerOutput& output,
+                     uint32_t period = 50);
+      ~ControllerMenu();
+
+      /**
+       * @brief Shows `page` with the cursor on its first item. Call before
+       * start().
+       *
+       */
+      void set_root(MenuPage& page);
+
+      void start();
+      void stop();
+
+      /**
+       * @brief A disabled menu ignores the buttons and leaves the screen
+       * alone, so the D-pad can drive the robot. Enabling redraws the menu.
+       * Menus start disabled.
+       *
+       * While the robot is connected to competition control and not
+       * disabled, the menu acts disabled whatever this is set to.
+       *
+       */
+      void set_enabled(bool is_enabled);
+      bool is_enabled() const;
+
+      /**
+       * @brief Reads the buttons and refreshes the screen once. start()
+       * calls it every period.
+       *
+       */
+      void update();
+
+     private:
+      struct Level {
+        MenuPage* page;
+        std::size_t cursor;
+        /**
+         * @brief First item on the top line
+         *
+         */
+        std::size_t scroll;
+      };
+
+      void menu_loop();
+      uint32_t read_presses();
+      void move_cursor(int direction);
+      void adjust(int direction);
+      void select();
+      void back();
+      void render();
+      void render_item(const MenuPage::Item& item, bool is_selected,
+                       char* line) const;
+
+      pros::Controller& controller;
+      ControllerOutput& output;
+      uint32_t period;
+      pros::Task* menu_task = nullptr;
+      std::atomic<bool> running{false};
+      std::atomic<bool> enabled{false};
+
+      // Only touched by the task calling update()
+      Level levels[MAX_DEPTH];
+      std::size_t depth = 0;
+      uint32_t held_buttons = 0;
+    };
+  }  // namespace util
+}  // namespace apollo
@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "apollo/telemetry/ringBuffer.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace util {
+    constexpr std::size_t CONTROLLER_LINE_COUNT = 3;
+    constexpr std::size_t CONTROLLER_LINE_WIDTH = 15;
+    /**
+     * @brief Longest rumble pattern the controller accepts
+     *
+     */
+    constexpr std::size_t CONTROLLER_RUMBLE_LENGTH = 8;
+
+    /**
+     * @brief Sends text and rumble patterns to a controller from its own
+     * task, so callers never wait on the radio.
+     *
+     * The radio takes about 50 ms per controller update. Calls only queue
+     * the request and return. The output task keeps the newest text of each
+     * line, skips lines that already show that text, and sends one update
+     * per period, with rumble patterns taking priority over text. An update
+     * only carries the characters between the first and last that changed,
+     * so a counter ticking at the end of a line sends one or two
+     * characters instead of the whole line.
+     *
+     * @code
+     * master_output.print(0, "Auton: %s", name);
+     * master_output.rumble("-");
+     * @endcode
+     */
+    class ControllerOutput {
+     public:
+      static constexpr std::size_t QUEUE_CAPACITY = 32;
+      static constexpr std::size_t RUMBLE_CAPACITY = 4;
+
+      /**
+       * @brief Construct a new Controller Output. Nothing is sent until
+       * start() is called, but text can be queued before.
+       *
+       * @param controller The controller to write to
+       * @param period Milliseconds between updates sent to the controller
+       */
+      explicit ControllerOutput(pros::Controller& controller,
+                                uint32_t period = 50);
+      ~ControllerOutput();
+
+      void start();
+      void stop();
+
+      /**
+       * @brief Sets the text of a line. Text longer than the line is cut and
+       * shorter text is padded, so the rest of the line is cleared. Safe to
+       * call from any task, never blocks.
+       *
+       * @param line The line, 0 to 2
+       * @param format printf style format string
+       * @return false if the queue was full and the text was dropped
+       */
+      bool print(uint8_t line, const char* format, ...)
+          __attribute__((format(printf, 3, 4)));
+      bool set_text(uint8_t line, const char* text);
+      bool clear_line(uint8_t line);
+      bool clear();
+
+      /**
+       * @brief Queues a rumble pattern of '.', '-' and ' '. Patterns are
+       * played in order and the oldest are kept if too many are waiting.
+       *
+       * @param pattern Up to CONTROLLER_RUMBLE_LENGTH characters
+       * @return false if the queue was full and the pattern was dropped
+       */
+      bool rumble(const char* pattern);
+
+     private:
+      enum command_type : uint8_t { COMMAND_TEXT, COMMAND_RUMBLE };
+
+      struct Command {
+        command_type type;
+        uint8_t line;
+        char text[CONTROLLER_LINE_WIDTH + 1];
+      };
+
+      bool push(command_type type, uint8_t line, const char* text);
+      void output_loop();
+      void drain();
+      bool send_next();
+
+      pros::Controller& controller;
+      uint32_t period;
+      telemetry::RingBuffer<Command, QUEUE_CAPACITY> queue;
+      pros::Task* output_task = nullptr;
+      std::atomic<bool> running{false};
+
+      // Only touched by the output task
+      char desired[CONTROLLER_LINE_COUNT][CONTROLLER_LINE_WIDTH + 1];
+      char shown[CONTROLLER_LINE_COUNT][CONTROLLER_LINE_WIDTH + 1];
+      char rumbles[RUMBLE_CAPACITY][CONTROLLER_RUMBLE_LENGTH + 1];
+      std::size_t rumble_count = 0;
+      std::size_t next_line = 0;
+    };
+  }  // namespace util
+}  // namespace apollo
+
+/**
+ * @brief Queued output for `master`. Started by initialize().
+ *
+ */
+extern apollo::util::ControllerOutput master_output;
@@ -24,7 +24,103 @@ namespace apollo {
       NORMAL_STRAFE_JOYSTICK
 
     };
+    /**
+     * @brief Ticks reported by an ADI quadrature encoder per shaft revolution
+     *
+     */
+    constexpr double ADI_ENCODER_TICK_PER_REVOLUTION = 360.0;
+    /**
+     * @brief Ticks (centidegrees) reported by a V5 Rotation Sensor per shaft
+     * revolution
+     *
+     */
+    constexpr double ROTATION_SENSOR_TICK_PER_REVOLUTION = 36000.0;
+
     bool is_reversed(double input);
-    extern int convert_gear_ratio(pros::v5::MotorGears input);
+    /**
+     * @brief Maps a joystick reading to a motor voltage
+     *
+     * @param joystick Joystick reading, -127 to 127
+     * @param deadband Readings with a magnitude up to this are treated as 0
+     * @return Millivolts, -12000 to 12000
+     */
+    constexpr int joystick_to_voltage(int joystick, int deadband) {
+      if(joystick > 127) {
+        joystick = 127;
+      } else if(joystick < -127) {
+        joystick = -127;
+      }
+      if(joystick <= deadband && joystick >= -deadband) {
+        return 0;
+      }
+      return joystick * 12000 / 127;
+    }
+    /**
+     * @brief Shapes a joystick reading so small movements give finer control
+     * while full deflection still gives full output
+     *
+     * @param joystick Joystick reading, -127 to 127
+     * @param curve 0 for a linear response up to 1 for a cubic one
+     * @return The shaped reading, -127 to 127
+     */
+    constexpr int apply_drive_curve(int joystick, double curve) {
+      const double cubic =
+          static_cast<double>(joystick) * joystick * joystick / (127.0 * 127.0);
+      return static_cast<int>(joystick + curve * (cubic - joystick));
+    }
+    /**
+     * @brief Maps a joystick reading to a drive voltage with the deadband
+     * and drive curve applied. The deadband applies to the raw reading, so
+     * the curve can't pull small movements past it into the dead zone.
+     *
+     * @param joystick Joystick reading, -127 to 127
+     * @param deadband Readings with a magnitude up to this are treated as 0
+     * @param curve 0 for a linear response up to 1 for a cubic one
+     * @return Millivolts, -12000 to 12000
+     */
+    constexpr int drive_voltage(int joystick, int deadband, double curve) {
+      if(joystick <= deadband && joystick >= -deadband) {
+        return 0;
+      }
+      return joystick_to_voltage(apply_drive_curve(joystick, curve), 0);
+    }
+    /**
+     * @brief Converts a motor cartridge into its free speed in RPM
+     *
+     * @param input The motor cartridge
+     * @return 100, 200 or 600, or INT32_MAX if the cartridge is unknown
+     */
+    constexpr int convert_gear_ratio(pros::v5::MotorGears input) {
+      switch(input) {
+        case pros::v5::MotorGears::red:
+          return 100;
+        case pros::v5::MotorGears::green:
+          return 200;
+        case pros::v5::MotorGears::blue:
+          return 600;
+        default:
+          return INT32_MAX;
+      }
+    }
+    /**
+     * @brief Ticks reported by a motor's integrated encoder per revolution of
+     * the cartridge's output shaft
+     *
+     * @param input The motor cartridge
+     * @return 1800, 900 or 300, or 0 if the cartridge is unknown
+     */
+    constexpr double get_cartridge_tick_per_revolution(
+        pros::v5::MotorGears input) {
+      switch(input) {
+        case pros::v5::MotorGears::red:
+          return 1800.0;
+        case pros::v5::MotorGears::green:
+          return 900.0;
+        case pros::v5::MotorGears::blue:
+          return 300.0;
+        default:
+          return 0.0;
+      }
+    }
   }  // namespace util
 }  // namespace apollo
\ No newline at end of file
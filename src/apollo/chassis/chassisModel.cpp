@@ -18,13 +18,77 @@ namespace apollo {
   pros::motor_encoder_units_e_t ChassisModel::get_encoder_units() {
     return current_encoder_units;
   }
+  std::size_t ChassisModel::get_device_count() const { return device_count; }
+  const chassis_device& ChassisModel::get_device(std::size_t index) const {
+    return devices[index];
+  }
+  void ChassisModel::add_device(chassis_device_type type, int port,
+                                int adi_port) {
+    if(port < 0) {
+      port = -port;
+    }
+    if(adi_port < 0) {
+      adi_port = -adi_port;
+    }
+    if(adi_port >= 'a' && adi_port <= 'h') {
+      adi_port -= 'a' - 1;
+    } else if(adi_port >= 'A' && adi_port <= 'H') {
+      adi_port -= 'A' - 1;
+    }
+    if(device_count == MAX_DEVICES) {
+      return;
+    }
+    devices[device_count++] = chassis_device{
+        type, static_cast<uint8_t>(port), static_cast<uint8_t>(adi_port)};
+  }
+  void ChassisModel::add_motor_devices(const std::vector<int8_t>& ports) {
+    for(int8_t port : ports) {
+      add_device(CHASSIS_DEVICE_MOTOR, port);
+    }
+  }
   void ChassisModel::set_joystick_deadband(int input) {
-    joystick_deadband = input;
+    joystick_deadband.store(input, std::memory_order_relaxed);
+  }
+  int ChassisModel::get_joystick_deadband() {
+    return joystick_deadband.load(std::memory_order_relaxed);
+  }
+  void ChassisModel::set_drive_curve(double curve) {
+    drive_curve.store(
+        static_cast<float>(curve < 0.0 ? 0.0 : curve > 1.0 ? 1.0 : curve),
+        std::memory_order_relaxed);
+  }
+  double ChassisModel::get_drive_curve() {
+    return drive_curve.load(std::memory_order_relaxed);
+  }
+  void ChassisModel::set_driver_output_scale(double scale) {
+    driver_output_scale.store(
+        static_cast<float>(scale < 0.0 ? 0.0 : scale > 1.0 ? 1.0 : scale),
+        std::memory_order_relaxed);
+  }
+  double ChassisModel::get_driver_output_scale() {
+    return driver_output_scale.load(std::memory_order_relaxed);
+  }
+  void ChassisModel::set_telemetry_logger(
+      telemetry::TelemetryLogger* logger) {
+    telemetry_logger.store(logger, std::memory_order_relaxed);
+  }
+
+  int ChassisModel::scale_driver_output(int output) {
+    // Clamped first, so a saturated arcade mix is still scaled down
+    if(output > 12000) {
+      output = 12000;
+    } else if(output < -12000) {
+      output = -12000;
+    }
+    return static_cast<int>(
+        output * driver_output_scale.load(std::memory_order_relaxed));
   }
-  int ChassisModel::get_joystick_deadband() { return joystick_deadband; }
 
-  int get_scaled_voltage(pros::controller_analog_e_t input) {
-    return (input * 12000) / 127;
+  int ChassisModel::get_scaled_voltage(pros::controller_analog_e_t input) {
+    return util::drive_voltage(
+        master.get_analog(input),
+        joystick_deadband.load(std::memory_order_relaxed),
+        drive_curve.load(std::memory_order_relaxed));
   }
 
   void ChassisModel::set_tank_joysticks(
@@ -11,6 +11,7 @@
 #include "pros/motor_group.hpp"
 #include "pros/motors.h"
 #include "pros/motors.hpp"
+#include "pros/rtos.hpp"
 
 namespace apollo {
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
@@ -30,20 +31,43 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    tracker_diameter = wheel_diameter;
-    tracker_circumference = wheel_circumference;
-    tracker_gear_ratio = wheel_gear_ratio;
+    current_tracker_type = util::DRIVE_MOTOR_ENCODER;
+    tracker_geometry = drivetrain_geometry;
+  }
+  TankModel::TankModel(std::vector<int8_t> left_motor_ports,
+                       std::vector<int8_t> right_motor_ports,
+                       int inertial_sensor_port, const DrivetrainConfig& config)
+      : inertial_sensor(inertial_sensor_port),
+        left_adi_encoder_tracker(-1, -1, false),
+        right_adi_encoder_tracker(-1, -1, false),
+        center_adi_encoder_tracker(-1, -1, false),
+        left_rotation_tracker(-1),
+        right_rotation_tracker(-1),
+        center_rotation_tracker(-1) {
+    pros::MotorGroup left_temp(left_motor_ports);
+    left_motor_group().append(left_temp);
+    pros::MotorGroup right_temp(right_motor_ports);
+    right_motor_group().append(right_temp);
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    drivetrain_config = config;
+    wheel_motor_cartridge = config.motor_cartridge;
+    drivetrain_geometry = config.get_geometry();
 
-    drivetrain_tick_per_revolution =
-        (50.0 * (3600.0 / wheel_motor_cartridge)) * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    current_tracker_type = util::DRIVE_MOTOR_ENCODER;
+    tracker_geometry = drivetrain_geometry;
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -69,19 +93,26 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
-
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, INTERNAL_ADI_PORT,
+               left_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, INTERNAL_ADI_PORT,
+               right_adi_encoder_ports[0]);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    current_tracker_type = util::DRIVE_ADI_ENCODER;
+    tracker_geometry =
+        DrivetrainGeometry(util::ADI_ENCODER_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -110,19 +141,29 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, INTERNAL_ADI_PORT,
+               left_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, INTERNAL_ADI_PORT,
+               right_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, INTERNAL_ADI_PORT,
+               center_adi_encoder_ports[0]);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
-
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    has_center_tracker = true;
+    current_tracker_type = util::DRIVE_ADI_ENCODER;
+    tracker_geometry =
+        DrivetrainGeometry(util::ADI_ENCODER_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -151,19 +192,26 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
-
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, expander_smart_port,
+               left_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, expander_smart_port,
+               right_adi_encoder_ports[0]);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    current_tracker_type = util::DRIVE_ADI_ENCODER;
+    tracker_geometry =
+        DrivetrainGeometry(util::ADI_ENCODER_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -196,19 +244,29 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, expander_smart_port,
+               left_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, expander_smart_port,
+               right_adi_encoder_ports[0]);
+    add_device(CHASSIS_DEVICE_ADI_ENCODER, expander_smart_port,
+               center_adi_encoder_ports[0]);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
-
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    has_center_tracker = true;
+    current_tracker_type = util::DRIVE_ADI_ENCODER;
+    tracker_geometry =
+        DrivetrainGeometry(util::ADI_ENCODER_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -229,19 +287,24 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
-
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ROTATION, left_rotation_port);
+    add_device(CHASSIS_DEVICE_ROTATION, right_rotation_port);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+    current_tracker_type = util::DRIVE_ROTATION_SENSOR;
+    tracker_geometry =
+        DrivetrainGeometry(util::ROTATION_SENSOR_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
   }
   TankModel::TankModel(std::vector<int8_t> left_motor_ports,
                        std::vector<int8_t> right_motor_ports,
@@ -263,40 +326,155 @@ namespace apollo {
     left_motor_group().append(left_temp);
     pros::MotorGroup right_temp(right_motor_ports);
     right_motor_group().append(right_temp);
-    wheel_motor_cartridge =
-        util::convert_gear_ratio(drivetrain_motor_cartridge);
-    wheel_diameter = drivetrain_wheel_diameter;
-    wheel_circumference = drivetrain_wheel_diameter * M_PI;
-    wheel_diameter = drivetrain_wheel_diameter;
+    add_motor_devices(left_motor_ports);
+    add_motor_devices(right_motor_ports);
+    add_device(CHASSIS_DEVICE_IMU, inertial_sensor_port);
+    add_device(CHASSIS_DEVICE_ROTATION, left_rotation_port);
+    add_device(CHASSIS_DEVICE_ROTATION, right_rotation_port);
+    add_device(CHASSIS_DEVICE_ROTATION, center_rotation_port);
+    drivetrain_config.motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_config.gear_ratio = drivetrain_gear_ratio;
+    drivetrain_config.wheel_diameter = drivetrain_wheel_diameter * units::inch;
+    drivetrain_config.motors_per_side =
+        static_cast<int>(left_motor_ports.size());
+    wheel_motor_cartridge = drivetrain_motor_cartridge;
+    drivetrain_geometry = drivetrain_config.get_geometry();
 
-    tracker_diameter = tracker_wheel_diameter;
-    tracker_circumference = tracker_diameter * M_PI;
-    tracker_gear_ratio = tracker_gear_ratio;
+    has_center_tracker = true;
+    current_tracker_type = util::DRIVE_ROTATION_SENSOR;
+    tracker_geometry =
+        DrivetrainGeometry(util::ROTATION_SENSOR_TICK_PER_REVOLUTION,
+                           tracker_gear_ratio,
+                           tracker_wheel_diameter * units::inch);
+  }
+  bool TankModel::drive_distance(units::QLength distance,
+                                 units::QTime timeout) {
+    // The controller only sees values as logged, so replay computes the
+    // same commands from the log
+    const float target = static_cast<float>(distance.convert(units::inch));
+    log_telemetry(telemetry::DriveTargetRecord{target, DRIVE_PERIOD, 1, 0});
+    bool is_settled = false;
+    bool is_started = false;
+    const uint32_t start_time = pros::millis();
+    const uint32_t timeout_ms =
+        static_cast<uint32_t>(timeout.convert(units::millisecond));
+    uint32_t wake_time = start_time;
+    while(!is_settled && pros::millis() - start_time < timeout_ms) {
+      telemetry::ChassisRecord chassis = read_chassis_sensors();
+      const units::QLength left =
+          drivetrain_geometry.ticks_to_length(chassis.left_position);
+      const units::QLength right =
+          drivetrain_geometry.ticks_to_length(chassis.right_position);
+      const units::QAngle heading = chassis.heading * units::degree;
+      if(!is_started) {
+        drive_controller.start(target * units::inch, left, right, heading);
+        is_started = true;
+      }
+      const DriveOutput output = drive_controller.step(
+          left, right, heading, DRIVE_PERIOD * units::millisecond);
+      left_motor_group().move_voltage(output.left_voltage);
+      right_motor_group().move_voltage(output.right_voltage);
+      chassis.left_voltage = static_cast<int16_t>(output.left_voltage);
+      chassis.right_voltage = static_cast<int16_t>(output.right_voltage);
+      log_telemetry(chassis);
+      track_pose(chassis);
+      is_settled =
+          drive_controller.is_settled(0.5 * units::inch, 1 * units::degree);
+      pros::Task::delay_until(&wake_time, DRIVE_PERIOD);
+    }
+    left_motor_group().move_voltage(0);
+    right_motor_group().move_voltage(0);
+    log_telemetry(telemetry::DriveTargetRecord{target, DRIVE_PERIOD, 0, 0});
+    return is_settled;
+  }
 
-    drivetrain_tick_per_revolution = wheel_motor_cartridge * tracker_gear_ratio;
-    drivetrain_tick_per_inch =
-        (drivetrain_tick_per_revolution / tracker_circumference);
+  Pose TankModel::update_odometry() {
+    const telemetry::ChassisRecord chassis = read_chassis_sensors();
+    log_telemetry(chassis);
+    track_pose(chassis);
+    return odometry.get_pose();
   }
-  void TankModel::tank_control() {
-    if(abs(master.get_analog(left_tank_joystick)) > joystick_deadband) {
-      left_motor_group().move(get_scaled_voltage(left_tank_joystick));
-    } else if(abs(master.get_analog(right_tank_joystick)) > joystick_deadband) {
-      right_motor_group().move(get_scaled_voltage(right_tank_joystick));
-    } else {
-      left_motor_group().move(0);
-      right_motor_group().move(0);
+
+  void TankModel::track_pose(const telemetry::ChassisRecord& chassis) {
+    // Odometry only sees values as logged, so replay integrates the same
+    // samples. The center wheel is logged but not used by Odometry yet.
+    float left = chassis.left_position;
+    float right = chassis.right_position;
+    const DrivetrainGeometry* geometry = &drivetrain_geometry;
+    if(current_tracker_type != util::DRIVE_MOTOR_ENCODER) {
+      telemetry::TrackerRecord tracker{0.0f, 0.0f, 0.0f};
+      if(current_tracker_type == util::DRIVE_ADI_ENCODER) {
+        tracker.left_position =
+            static_cast<float>(left_adi_encoder_tracker.get_value());
+        tracker.right_position =
+            static_cast<float>(right_adi_encoder_tracker.get_value());
+        if(has_center_tracker) {
+          tracker.center_position =
+              static_cast<float>(center_adi_encoder_tracker.get_value());
+        }
+      } else {
+        tracker.left_position =
+            static_cast<float>(left_rotation_tracker.get_position());
+        tracker.right_position =
+            static_cast<float>(right_rotation_tracker.get_position());
+        if(has_center_tracker) {
+          tracker.center_position =
+              static_cast<float>(center_rotation_tracker.get_position());
+        }
+      }
+      log_telemetry(tracker);
+      left = tracker.left_position;
+      right = tracker.right_position;
+      geometry = &tracker_geometry;
     }
+    odometry.update(geometry->ticks_to_length(left),
+                    geometry->ticks_to_length(right),
+                    -chassis.heading * units::degree);
+    const Pose pose = odometry.get_pose();
+    log_telemetry(telemetry::PoseRecord{
+        static_cast<float>(pose.x.convert(units::meter)),
+        static_cast<float>(pose.y.convert(units::meter)),
+        static_cast<float>(pose.theta.convert(units::radian))});
+  }
+
+  telemetry::ChassisRecord TankModel::read_chassis_sensors() {
+    // Raw counts, whatever the encoder units are set to
+    uint32_t timestamp;
+    telemetry::ChassisRecord chassis;
+    chassis.left_position =
+        static_cast<float>(left_motor_group().get_raw_position(&timestamp));
+    chassis.right_position =
+        static_cast<float>(right_motor_group().get_raw_position(&timestamp));
+    chassis.left_velocity =
+        static_cast<float>(left_motor_group().get_actual_velocity());
+    chassis.right_velocity =
+        static_cast<float>(right_motor_group().get_actual_velocity());
+    chassis.left_voltage = 0;
+    chassis.right_voltage = 0;
+    chassis.heading = static_cast<float>(inertial_sensor.get_rotation());
+    return chassis;
+  }
+
+  void TankModel::tank_control() {
+    // Each stick and setting is read once, so a tuning panel store can't
+    // give the two sides of one tick different deadbands
+    const int deadband = get_joystick_deadband();
+    const double curve = get_drive_curve();
+    const int left = master.get_analog(left_tank_joystick);
+    const int right = master.get_analog(right_tank_joystick);
+    left_motor_group().move_voltage(
+        scale_driver_output(util::drive_voltage(left, deadband, curve)));
+    right_motor_group().move_voltage(
+        scale_driver_output(util::drive_voltage(right, deadband, curve)));
   }
   void TankModel::arcade_control(bool is_flipped, bool is_split) {
-    if(abs(master.get_analog(forward_arcade_joystick)) > joystick_deadband ||
-       abs(master.get_analog(turn_arcade_joystick)) > joystick_deadband) {
-      left_motor_group().move(get_scaled_voltage(forward_arcade_joystick) +
-                              get_scaled_voltage(turn_arcade_joystick));
-      right_motor_group().move(get_scaled_voltage(forward_arcade_joystick) -
-                               get_scaled_voltage(turn_arcade_joystick));
-    } else {
-      left_motor_group().move(0);
-      right_motor_group().move(0);
-    }
+    const int deadband = get_joystick_deadband();
+    const double curve = get_drive_curve();
+    const int forward = util::drive_voltage(
+        master.get_analog(forward_arcade_joystick), deadband, curve);
+    const int turn = util::drive_voltage(
+        master.get_analog(turn_arcade_joystick), deadband, curve);
+    left_motor_group().move_voltage(scale_driver_output(forward + turn));
+    right_motor_group().move_voltage(scale_driver_output(forward - turn));
   }
 }  // namespace apollo
\ No newline at end of file
@@ -0,0 +1,226 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/chassis/motorHealthMonitor.hpp"
+
+#include "apollo/util/controllerOutput.hpp"
+#include "pros/error.h"
+#include "pros/motors.h"
+
+namespace apollo {
+  namespace {
+    /**
+     * @brief Degrees Celsius between temperature readings of a motor
+     *
+     */
+    constexpr double TEMPERATURE_STEP = 5.0;
+  }  // namespace
+
+  MotorHealthMonitor::MotorHealthMonitor(ChassisModel& chassis,
+                                         const std::vector<int8_t>& motor_ports,
+                                         uint32_t period)
+      : chassis(chassis), period(period) {
+    for(int8_t port : motor_ports) {
+      if(motor_count == MAX_MOTORS) {
+        break;
+      }
+      ports[motor_count++] = static_cast<int8_t>(port < 0 ? -port : port);
+    }
+  }
+
+  MotorHealthMonitor::~MotorHealthMonitor() { stop(); }
+
+  void MotorHealthMonitor::start() {
+    if(running.exchange(true)) {
+      return;
+    }
+    monitor_task =
+        new pros::Task([this] { monitor_loop(); }, TASK_PRIORITY_MIN + 1,
+                       TASK_STACK_DEPTH_DEFAULT, "apollo motor health");
+  }
+
+  void MotorHealthMonitor::stop() {
+    if(!running.exchange(false)) {
+      return;
+    }
+    monitor_task->join();
+    delete monitor_task;
+    monitor_task = nullptr;
+    chassis.set_driver_output_scale(1.0);
+  }
+
+  void MotorHealthMonitor::set_throttling(double start_temperature,
+                                          double minimum_scale) {
+    throttle_temperature.store(start_temperature);
+    this->minimum_scale.store(minimum_scale);
+  }
+
+  void MotorHealthMonitor::set_throttling_enabled(bool enabled) {
+    throttling_enabled.store(enabled);
+    if(!enabled) {
+      chassis.set_driver_output_scale(1.0);
+    }
+  }
+
+  void MotorHealthMonitor::set_warning(bool enabled, units::QTime horizon) {
+    warning_enabled.store(enabled);
+    warning_horizon.store(horizon.convert(units::second));
+  }
+
+  std::size_t MotorHealthMonitor::get_motor_count() const {
+    return motor_count;
+  }
+
+  MotorHealth MotorHealthMonitor::get_motor_health(std::size_t index) const {
+    if(index >= motor_count) {
+      return MotorHealth();
+    }
+    health_mutex.take();
+    const MotorHealth result = health[index];
+    health_mutex.give();
+    return result;
+  }
+
+  double MotorHealthMonitor::get_hottest_temperature() const {
+    health_mutex.take();
+    const double result = hottest_temperature;
+    health_mutex.give();
+    return result;
+  }
+
+  double MotorHealthMonitor::get_estimated_temperature() const {
+    health_mutex.take();
+    const double result = estimated_temperature;
+    health_mutex.give();
+    return result;
+  }
+
+  units::QTime MotorHealthMonitor::get_time_to_limit() const {
+    health_mutex.take();
+    const double result = time_to_limit;
+    health_mutex.give();
+    return result * units::second;
+  }
+
+  void MotorHealthMonitor::monitor_loop() {
+    uint32_t wake_time = pros::millis();
+    while(running.load()) {
+      sample();
+      pros::Task::delay_until(&wake_time, period);
+    }
+  }
+
+  void MotorHealthMonitor::sample() {
+    // Read every motor before taking the lock, so readers never wait on the
+    // device reads
+    MotorHealth samples[MAX_MOTORS];
+    double hottest = 0.0;
+    for(std::size_t i = 0; i < motor_count; i++) {
+      MotorHealth& motor = samples[i];
+      motor.temperature = pros::c::motor_get_temperature(ports[i]);
+      motor.is_connected = motor.temperature != PROS_ERR_F;
+      if(!motor.is_connected) {
+        motor.temperature = 0.0;
+        continue;
+      }
+      motor.current = pros::c::motor_get_current_draw(ports[i]);
+      motor.efficiency = pros::c::motor_get_efficiency(ports[i]);
+      motor.is_over_temperature = pros::c::motor_is_over_temp(ports[i]) == 1;
+      if(motor.temperature > hottest) {
+        hottest = motor.temperature;
+      }
+    }
+
+    const uint32_t now = pros::millis();
+    if(last_temperature == 0.0) {
+      // First reading, or the motors were unplugged: nothing to compare to
+      rise_count = 0;
+    } else if(hottest > last_temperature) {
+      previous_rise_time = last_rise_time;
+      last_rise_time = now;
+      last_rise = hottest - last_temperature;
+      rise_count++;
+    } else if(hottest < last_temperature) {
+      rise_count = 0;
+    }
+    last_temperature = hottest;
+
+    double seconds_to_limit = -1.0;
+    double estimated = hottest;
+    if(hottest >= MOTOR_THERMAL_LIMIT_TEMPERATURE) {
+      seconds_to_limit = 0.0;
+    } else if(rise_count >= 2) {
+      const uint32_t interval = last_rise_time - previous_rise_time;
+      const uint32_t elapsed = now - last_rise_time;
+      double rate = last_rise / (interval / 1000.0);
+      if(elapsed <= interval) {
+        // The reading rose to `hottest` at the last step and the motor has
+        // kept heating since, toward the next step
+        estimated = hottest + last_rise * elapsed / interval;
+      } else {
+        // A step that is overdue means the motor is heating slower than
+        // before, so it is likely further below the next step than the
+        // last rate says
+        rate = last_rise / (elapsed / 1000.0);
+        estimated = hottest + last_rise * interval / elapsed;
+      }
+      if(estimated > hottest + TEMPERATURE_STEP) {
+        estimated = hottest + TEMPERATURE_STEP;
+      }
+      seconds_to_limit = (MOTOR_THERMAL_LIMIT_TEMPERATURE - estimated) / rate;
+      if(seconds_to_limit < 0.0) {
+        seconds_to_limit = 0.0;
+      }
+    }
+
+    health_mutex.take();
+    for(std::size_t i = 0; i < motor_count; i++) {
+      health[i] = samples[i];
+    }
+    hottest_temperature = hottest;
+    estimated_temperature = estimated;
+    time_to_limit = seconds_to_limit;
+    health_mutex.give();
+
+    if(throttling_enabled.load()) {
+      chassis.set_driver_output_scale(get_throttle_scale(estimated));
+    }
+    update_warning(hottest, seconds_to_limit * units::second);
+  }
+
+  double MotorHealthMonitor::get_throttle_scale(double temperature) const {
+    const double start = throttle_temperature.load();
+    const double minimum = minimum_scale.load();
+    if(temperature <= start || start >= MOTOR_THERMAL_LIMIT_TEMPERATURE) {
+      return 1.0;
+    }
+    if(temperature >= MOTOR_THERMAL_LIMIT_TEMPERATURE) {
+      return minimum;
+    }
+    const double progress =
+        (temperature - start) / (MOTOR_THERMAL_LIMIT_TEMPERATURE - start);
+    return 1.0 - progress * (1.0 - minimum);
+  }
+
+  void MotorHealthMonitor::update_warning(double temperature,
+                                          units::QTime time_to_limit) {
+    const double seconds = time_to_limit.convert(units::second);
+    const bool should_warn = warning_enabled.load() && seconds >= 0.0 &&
+                             seconds <= warning_horizon.load();
+    if(should_warn) {
+      if(!is_warning) {
+        master_output.rumble("--");
+      }
+      if(seconds == 0.0) {
+        master_output.print(2, "DRIVE HOT %.0fC", temperature);
+      } else {
+        master_output.print(2, "DRIVE %.0fC %.0fs", temperature, seconds);
+      }
+    } else if(is_warning) {
+      master_output.clear_line(2);
+    }
+    is_warning = should_warn;
+  }
+}  // namespace apollo
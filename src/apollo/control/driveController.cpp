@@ -0,0 +1,73 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/control/driveController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace apollo {
+  DriveController::DriveController(const PIDController& distance_pid,
+                                   const PIDController& heading_pid,
+                                   int max_voltage)
+      : distance_pid(distance_pid),
+        heading_pid(heading_pid),
+        max_voltage(max_voltage) {}
+
+  void DriveController::start(units::QLength distance,
+                              units::QLength left_distance,
+                              units::QLength right_distance,
+                              units::QAngle heading) {
+    target_distance = distance;
+    start_left_distance = left_distance;
+    start_right_distance = right_distance;
+    target_heading = units::BinaryAngle(heading);
+    distance_error = distance;
+    heading_error = units::QAngle(0.0);
+    distance_pid.reset();
+    heading_pid.reset();
+  }
+
+  DriveOutput DriveController::step(units::QLength left_distance,
+                                    units::QLength right_distance,
+                                    units::QAngle heading,
+                                    units::QTime time_step) {
+    const units::QLength travelled = ((left_distance - start_left_distance) +
+                                      (right_distance - start_right_distance)) /
+                                     2;
+    distance_error = target_distance - travelled;
+    // Shortest way back to the target, in case the heading wraps
+    heading_error =
+        units::BinaryAngle(heading).shortest_difference(target_heading);
+
+    const double limit = max_voltage;
+    const double forward = std::clamp(
+        distance_pid.step(distance_error.convert(units::inch), time_step),
+        -limit, limit);
+    const double turn = std::clamp(
+        heading_pid.step(heading_error.convert(units::degree), time_step),
+        -limit, limit);
+    // Scale both sides down together, which keeps the turn when driving
+    // and turning don't both fit
+    double left = forward + turn;
+    double right = forward - turn;
+    const double largest = std::max(std::fabs(left), std::fabs(right));
+    if(largest > limit) {
+      left *= limit / largest;
+      right *= limit / largest;
+    }
+    return DriveOutput{static_cast<int>(std::lround(left)),
+                       static_cast<int>(std::lround(right))};
+  }
+
+  bool DriveController::is_settled(units::QLength distance_tolerance,
+                                   units::QAngle heading_tolerance) const {
+    return units::abs(distance_error) <= distance_tolerance &&
+           units::abs(heading_error) <= heading_tolerance;
+  }
+
+  PIDController& DriveController::get_distance_pid() { return distance_pid; }
+  PIDController& DriveController::get_heading_pid() { return heading_pid; }
+}  // namespace apollo
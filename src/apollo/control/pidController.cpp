@@ -0,0 +1,46 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/control/pidController.hpp"
+
+namespace apollo {
+  PIDController::PIDController(double kP, double kI, double kD,
+                               double integral_limit)
+      : kP(kP), kI(kI), kD(kD), integral_limit(integral_limit) {}
+
+  double PIDController::step(double error, units::QTime time_step) {
+    const double seconds = time_step.convert(units::second);
+    integral += kI * error * seconds;
+    if(integral_limit > 0.0) {
+      if(integral > integral_limit) {
+        integral = integral_limit;
+      } else if(integral < -integral_limit) {
+        integral = -integral_limit;
+      }
+    }
+    double derivative = 0.0;
+    if(has_previous_error && seconds > 0.0) {
+      derivative = (error - previous_error) / seconds;
+    }
+    previous_error = error;
+    has_previous_error = true;
+    return kP * error + integral + kD * derivative;
+  }
+
+  void PIDController::reset() {
+    integral = 0.0;
+    previous_error = 0.0;
+    has_previous_error = false;
+  }
+
+  void PIDController::set_gains(double kP, double kI, double kD) {
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
+  }
+  double PIDController::get_kP() const { return kP; }
+  double PIDController::get_kI() const { return kI; }
+  double PIDController::get_kD() const { return kD; }
+}  // namespace apollo
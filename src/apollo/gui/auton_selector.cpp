@@ -3,5 +3,322 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include <cstdio>
+#include <cstring>
+
 #include "apollo/gui/gui.hpp"
-#include "main.h"
+#include "pros/misc.hpp"
+
+namespace apollo {
+  namespace {
+    constexpr int PAGE_SIZE = static_cast<int>(GUI::AUTONS_PER_PAGE);
+    constexpr std::size_t DESCRIPTION_LINE_COUNT = 4;
+    constexpr std::size_t DESCRIPTION_LINE_WIDTH = 28;
+
+    constexpr int16_t auton_button_top(std::size_t button) {
+      return static_cast<int16_t>(28 + button * 46);
+    }
+    constexpr int16_t description_top(std::size_t line) {
+      return static_cast<int16_t>(28 + line * 22);
+    }
+
+    /**
+     * @brief Copies the next line of at most DESCRIPTION_LINE_WIDTH
+     * characters from `text`, breaking at the last space that fits
+     *
+     * @return The start of the remaining text
+     */
+    const char* wrap_line(const char* text, char* line) {
+      while(*text == ' ') {
+        text++;
+      }
+      std::size_t length = std::strlen(text);
+      if(length > DESCRIPTION_LINE_WIDTH) {
+        length = DESCRIPTION_LINE_WIDTH;
+        for(std::size_t i = DESCRIPTION_LINE_WIDTH; i > 0; i--) {
+          if(text[i] == ' ') {
+            length = i;
+            break;
+          }
+        }
+      }
+      std::memcpy(line, text, length);
+      line[length] = '\0';
+      return text + length;
+    }
+  }  // namespace
+
+  struct GUI::AutonSelectorPage {
+    gui::Label title{{0, 0, 479, 23}, "", pros::E_TEXT_MEDIUM};
+    gui::Button autons[AUTONS_PER_PAGE] = {
+        {{0, auton_button_top(0), 229, auton_button_top(0) + 41}, ""},
+        {{0, auton_button_top(1), 229, auton_button_top(1) + 41}, ""},
+        {{0, auton_button_top(2), 229, auton_button_top(2) + 41}, ""},
+        {{0, auton_button_top(3), 229, auton_button_top(3) + 41}, ""}};
+    gui::Button previous_page{{0, 214, 109, 239}, "<"};
+    gui::Button next_page{{120, 214, 229, 239}, ">"};
+    gui::Label description[DESCRIPTION_LINE_COUNT] = {
+        {{240, description_top(0), 479, description_top(0) + 21}},
+        {{240, description_top(1), 479, description_top(1) + 21}},
+        {{240, description_top(2), 479, description_top(2) + 21}},
+        {{240, description_top(3), 479, description_top(3) + 21}}};
+    gui::Button left_side{{240, 166, 354, 207}, "Left side"};
+    gui::Button right_side{{365, 166, 479, 207}, "Right side"};
+    gui::Label status{{240, 214, 479, 239}};
+    gui::Page page;
+  };
+
+  GUI::~GUI() {
+    stop();
+    delete auton_selector;
+  }
+
+  bool GUI::add_auton(const char* name, const char* description,
+                      void (*autonomous_function)()) {
+    if(total_autons == static_cast<int>(MAX_AUTONS)) {
+      return false;
+    }
+    autons[total_autons++] = auton{name, description, autonomous_function};
+    return true;
+  }
+
+  void GUI::show_auton_selector(const char* path) {
+    auton_file_path = path;
+    if(auton_selector == nullptr) {
+      auton_selector = new AutonSelectorPage();
+      AutonSelectorPage& selector = *auton_selector;
+      selector.page.add(selector.title);
+      for(gui::Button& button : selector.autons) {
+        selector.page.add(button);
+      }
+      selector.autons[0].set_callback(on_auton_pressed<0>, this);
+      selector.autons[1].set_callback(on_auton_pressed<1>, this);
+      selector.autons[2].set_callback(on_auton_pressed<2>, this);
+      selector.autons[3].set_callback(on_auton_pressed<3>, this);
+      selector.previous_page.set_callback(on_previous_page_pressed, this);
+      selector.next_page.set_callback(on_next_page_pressed, this);
+      selector.left_side.set_callback(on_left_side_pressed, this);
+      selector.right_side.set_callback(on_right_side_pressed, this);
+      selector.page.add(selector.previous_page);
+      selector.page.add(selector.next_page);
+      for(gui::Label& line : selector.description) {
+        selector.page.add(line);
+      }
+      selector.page.add(selector.left_side);
+      selector.page.add(selector.right_side);
+      selector.page.add(selector.status);
+    }
+    is_auton_selector_enabled = true;
+
+    if(!load_auton_selection()) {
+      auton_selector->status.set_text(pros::usd::is_installed()
+                                          ? "No saved selection"
+                                          : "No SD card, not saved");
+    } else {
+      auton_selector->status.set_text("Loaded saved selection");
+    }
+    select_field_side(selected_side.load());
+    select_auton(selected_auton.load());
+    show_auton_page(selected_auton.load() / PAGE_SIZE);
+    set_page(auton_selector->page);
+  }
+
+  const auton* GUI::get_selected_auton() const {
+    if(total_autons == 0) {
+      return nullptr;
+    }
+    return &autons[selected_auton.load(std::memory_order_relaxed)];
+  }
+
+  int GUI::get_selected_auton_index() const {
+    return selected_auton.load(std::memory_order_relaxed);
+  }
+
+  field_side GUI::get_field_side() const {
+    return selected_side.load(std::memory_order_relaxed);
+  }
+
+  int GUI::get_auton_count() const { return total_autons; }
+
+  const char* GUI::get_auton_name(int index) const {
+    if(index < 0 || index >= total_autons) {
+      return nullptr;
+    }
+    return autons[index].name;
+  }
+
+  bool GUI::post_auton_selection(int index, field_side side) {
+    if(index < 0 || index >= total_autons) {
+      return false;
+    }
+    Message message;
+    message.type = MESSAGE_AUTON;
+    message.target = nullptr;
+    message.values[0] = index;
+    message.values[1] = side;
+    return push(message);
+  }
+
+  void GUI::apply_auton_selection(int index, field_side side) {
+    if(index < 0 || index >= total_autons) {
+      return;
+    }
+    if(auton_selector == nullptr) {
+      selected_auton.store(index);
+      selected_side.store(side);
+      return;
+    }
+    select_field_side(side);
+    show_auton_page(index / PAGE_SIZE);
+    select_auton(index);
+    save_auton_selection();
+  }
+
+  bool GUI::run_selected_auton() const {
+    const auton* routine = get_selected_auton();
+    if(routine == nullptr || routine->autonomous_function == nullptr) {
+      return false;
+    }
+    routine->autonomous_function();
+    return true;
+  }
+
+  void GUI::show_auton_page(int page) {
+    const int page_count =
+        total_autons == 0 ? 1 : (total_autons + PAGE_SIZE - 1) /
+                                    PAGE_SIZE;
+    curent_auton_page = (page % page_count + page_count) % page_count;
+    AutonSelectorPage& selector = *auton_selector;
+    selector.title.print("Autonomous  %d/%d", curent_auton_page + 1,
+                         page_count);
+    for(int button = 0; button < PAGE_SIZE; button++) {
+      const int index = curent_auton_page * PAGE_SIZE + button;
+      gui::Button& widget = selector.autons[button];
+      if(index < total_autons) {
+        widget.set_text(autons[index].name);
+        widget.set_selected(index == selected_auton.load());
+        widget.set_colors(gui::COLOR_FOREGROUND, background);
+      } else {
+        // Slots past the last routine are drawn in the background color
+        widget.set_text("");
+        widget.set_selected(false);
+        widget.set_colors(background, background);
+      }
+    }
+  }
+
+  void GUI::select_auton(int index) {
+    if(index < 0 || index >= total_autons) {
+      return;
+    }
+    selected_auton.store(index);
+    AutonSelectorPage& selector = *auton_selector;
+    for(int button = 0; button < PAGE_SIZE; button++) {
+      selector.autons[button].set_selected(
+          curent_auton_page * PAGE_SIZE + button == index);
+    }
+    const char* text =
+        autons[index].description != nullptr ? autons[index].description : "";
+    for(gui::Label& line : selector.description) {
+      char wrapped[DESCRIPTION_LINE_WIDTH + 1];
+      text = wrap_line(text, wrapped);
+      line.set_text(wrapped);
+    }
+  }
+
+  void GUI::select_field_side(field_side side) {
+    selected_side.store(side);
+    auton_selector->left_side.set_selected(side == FIELD_SIDE_LEFT);
+    auton_selector->right_side.set_selected(side == FIELD_SIDE_RIGHT);
+  }
+
+  template <int BUTTON>
+  void GUI::on_auton_pressed(void* context) {
+    GUI& self = *static_cast<GUI*>(context);
+    const int index = self.curent_auton_page * PAGE_SIZE + BUTTON;
+    if(index >= self.total_autons || index == self.selected_auton.load()) {
+      return;
+    }
+    self.select_auton(index);
+    self.save_auton_selection();
+  }
+
+  void GUI::on_previous_page_pressed(void* context) {
+    GUI& self = *static_cast<GUI*>(context);
+    self.show_auton_page(self.curent_auton_page - 1);
+  }
+
+  void GUI::on_next_page_pressed(void* context) {
+    GUI& self = *static_cast<GUI*>(context);
+    self.show_auton_page(self.curent_auton_page + 1);
+  }
+
+  void GUI::on_left_side_pressed(void* context) {
+    GUI& self = *static_cast<GUI*>(context);
+    if(self.selected_side.load() != FIELD_SIDE_LEFT) {
+      self.select_field_side(FIELD_SIDE_LEFT);
+      self.save_auton_selection();
+    }
+  }
+
+  void GUI::on_right_side_pressed(void* context) {
+    GUI& self = *static_cast<GUI*>(context);
+    if(self.selected_side.load() != FIELD_SIDE_RIGHT) {
+      self.select_field_side(FIELD_SIDE_RIGHT);
+      self.save_auton_selection();
+    }
+  }
+
+  bool GUI::load_auton_selection() {
+    if(auton_file_path == nullptr || !pros::usd::is_installed()) {
+      return false;
+    }
+    std::FILE* file = std::fopen(auton_file_path, "r");
+    if(file == nullptr) {
+      return false;
+    }
+    // "left" or "right" on the first line, the routine's name on the second
+    char text[128];
+    const std::size_t length = std::fread(text, 1, sizeof(text) - 1, file);
+    std::fclose(file);
+    text[length] = '\0';
+    char* name = std::strchr(text, '\n');
+    if(name == nullptr) {
+      return false;
+    }
+    *name++ = '\0';
+    char* name_end = std::strchr(name, '\n');
+    if(name_end != nullptr) {
+      *name_end = '\0';
+    }
+    selected_side.store(std::strcmp(text, "right") == 0 ? FIELD_SIDE_RIGHT
+                                                        : FIELD_SIDE_LEFT);
+    // Matched by name, so adding or reordering routines keeps the selection
+    for(int i = 0; i < total_autons; i++) {
+      if(std::strcmp(autons[i].name, name) == 0) {
+        selected_auton.store(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool GUI::save_auton_selection() {
+    if(auton_file_path == nullptr || total_autons == 0) {
+      return false;
+    }
+    bool is_saved = false;
+    std::FILE* file = pros::usd::is_installed()
+                          ? std::fopen(auton_file_path, "w")
+                          : nullptr;
+    if(file != nullptr) {
+      const int written = std::fprintf(
+          file, "%s\n%s\n",
+          selected_side.load() == FIELD_SIDE_RIGHT ? "right" : "left",
+          autons[selected_auton.load()].name);
+      is_saved = std::fclose(file) == 0 && written > 0;
+    }
+    auton_selector->status.set_text(is_saved ? "Saved" : "Not saved");
+    return is_saved;
+  }
+}  // namespace apollo
@@ -0,0 +1,273 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/fieldMap.hpp"
+
+#include <cmath>
+#include <new>
+
+#include "pros/screen.hpp"
+
+namespace apollo {
+  namespace gui {
+    namespace {
+      constexpr uint32_t COLOR_FIELD = 0x00303030;
+      constexpr uint32_t COLOR_TILE_LINE = 0x00505050;
+      constexpr uint32_t COLOR_PATH = static_cast<uint32_t>(pros::Color::gold);
+      constexpr uint32_t COLOR_TRAIL = COLOR_ACCENT;
+      constexpr uint32_t COLOR_ROBOT = COLOR_FOREGROUND;
+      // The robot is redrawn when its heading changes by this much
+      constexpr double HEADING_RESOLUTION = 0.035;
+
+      constexpr bool intersects(const Rect& a, const Rect& b) {
+        return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+      }
+
+      int16_t min(int16_t a, int16_t b) { return a < b ? a : b; }
+      int16_t max(int16_t a, int16_t b) { return a > b ? a : b; }
+
+      double clamp(double value, double minimum, double maximum) {
+        return value < minimum ? minimum : (value > maximum ? maximum : value);
+      }
+    }  // namespace
+
+    FieldMap::FieldMap(Rect bounds, units::QLength field_size,
+                       units::QLength robot_size)
+        : Widget(bounds),
+          field_pixels(min(bounds.get_width(), bounds.get_height())),
+          pixels_per_meter(field_pixels / field_size.convert(units::meter)),
+          robot_half_size(static_cast<int16_t>(
+              robot_size.convert(units::meter) * pixels_per_meter / 2)),
+          background_pixels(new(std::nothrow)
+                                uint32_t[field_pixels * field_pixels]) {
+      render_background();
+    }
+
+    FieldMap::~FieldMap() { delete[] background_pixels; }
+
+    void FieldMap::set_pose(const Pose& pose) {
+      const Point position = to_screen(pose.x, pose.y);
+      const double theta = pose.theta.convert(units::radian);
+      const bool has_moved =
+          !has_pose || position.x != robot.x || position.y != robot.y ||
+          std::fabs(theta - robot_theta) > HEADING_RESOLUTION;
+      if(!has_moved) {
+        return;
+      }
+      robot = position;
+      robot_theta = theta;
+      has_pose = true;
+
+      const Point* last = trail_count > 0
+                              ? &trail[(trail_count - 1) % TRAIL_CAPACITY]
+                              : nullptr;
+      if(last == nullptr || std::abs(position.x - last->x) >= TRAIL_SPACING ||
+         std::abs(position.y - last->y) >= TRAIL_SPACING) {
+        trail[trail_count % TRAIL_CAPACITY] = position;
+        trail_count++;
+      }
+      mark_dirty();
+    }
+
+    bool FieldMap::set_path(const Pose* poses, std::size_t count) {
+      path_count = count < MAX_PATH_POINTS ? count : MAX_PATH_POINTS;
+      for(std::size_t i = 0; i < path_count; i++) {
+        path[i] = to_screen(poses[i].x, poses[i].y);
+      }
+      invalidate();
+      return count <= MAX_PATH_POINTS;
+    }
+
+    void FieldMap::clear_path() {
+      path_count = 0;
+      invalidate();
+    }
+
+    void FieldMap::clear_trail() {
+      trail_count = 0;
+      invalidate();
+    }
+
+    FieldMap::Point FieldMap::to_screen(units::QLength x,
+                                        units::QLength y) const {
+      const double half = field_pixels / 2.0;
+      const double column = clamp(
+          half + x.convert(units::meter) * pixels_per_meter, 0.0,
+          field_pixels - 1);
+      const double row = clamp(
+          half - y.convert(units::meter) * pixels_per_meter, 0.0,
+          field_pixels - 1);
+      return Point{static_cast<int16_t>(bounds.x0 + column),
+                   static_cast<int16_t>(bounds.y0 + row)};
+    }
+
+    Rect FieldMap::get_segment_box(Point start, Point end) const {
+      return Rect{min(start.x, end.x), min(start.y, end.y), max(start.x, end.x),
+                  max(start.y, end.y)};
+    }
+
+    Rect FieldMap::get_robot_box() const {
+      // Covers the square at any heading
+      const int16_t reach =
+          static_cast<int16_t>(std::ceil(robot_half_size * std::sqrt(2.0))) + 1;
+      return Rect{static_cast<int16_t>(robot.x - reach),
+                  static_cast<int16_t>(robot.y - reach),
+                  static_cast<int16_t>(robot.x + reach),
+                  static_cast<int16_t>(robot.y + reach)};
+    }
+
+    void FieldMap::render_background() {
+      if(background_pixels == nullptr) {
+        return;
+      }
+      const double tile_pixels = units::tile.convert(units::meter) *
+                                 pixels_per_meter;
+      const int16_t last = field_pixels - 1;
+      for(int16_t row = 0; row < field_pixels; row++) {
+        const bool is_tile_row = static_cast<int>(row / tile_pixels) !=
+                                 static_cast<int>((row + 1) / tile_pixels);
+        for(int16_t column = 0; column < field_pixels; column++) {
+          const bool is_border =
+              row == 0 || row == last || column == 0 || column == last;
+          const bool is_tile_column =
+              static_cast<int>(column / tile_pixels) !=
+              static_cast<int>((column + 1) / tile_pixels);
+          uint32_t color = COLOR_FIELD;
+          if(is_border) {
+            color = COLOR_FOREGROUND;
+          } else if(is_tile_row || is_tile_column) {
+            color = COLOR_TILE_LINE;
+          }
+          background_pixels[row * field_pixels + column] = color;
+        }
+      }
+    }
+
+    void FieldMap::restore(Rect area) {
+      const Rect field{bounds.x0, bounds.y0,
+                       static_cast<int16_t>(bounds.x0 + field_pixels - 1),
+                       static_cast<int16_t>(bounds.y0 + field_pixels - 1)};
+      area.x0 = max(area.x0, field.x0);
+      area.y0 = max(area.y0, field.y0);
+      area.x1 = min(area.x1, field.x1);
+      area.y1 = min(area.y1, field.y1);
+      if(area.x0 > area.x1 || area.y0 > area.y1) {
+        return;
+      }
+      if(background_pixels == nullptr) {
+        pros::screen::set_pen(COLOR_FIELD);
+        pros::screen::fill_rect(area.x0, area.y0, area.x1, area.y1);
+        return;
+      }
+      uint32_t* first = background_pixels +
+                        (area.y0 - field.y0) * field_pixels +
+                        (area.x0 - field.x0);
+      pros::screen::copy_area(area.x0, area.y0, area.x1, area.y1, first,
+                              field_pixels);
+    }
+
+    void FieldMap::redraw_over(const Rect& area) {
+      pros::screen::set_pen(COLOR_PATH);
+      for(std::size_t i = 1; i < path_count; i++) {
+        if(intersects(get_segment_box(path[i - 1], path[i]), area)) {
+          pros::screen::draw_line(path[i - 1].x, path[i - 1].y, path[i].x,
+                                  path[i].y);
+        }
+      }
+      const uint32_t first =
+          trail_count > TRAIL_LENGTH ? trail_count - TRAIL_LENGTH : 0;
+      for(uint32_t index = first + 1; index < drawn_trail_count; index++) {
+        const Point& start = trail[(index - 1) % TRAIL_CAPACITY];
+        const Point& end = trail[index % TRAIL_CAPACITY];
+        if(intersects(get_segment_box(start, end), area)) {
+          draw_trail_segment(index);
+        }
+      }
+    }
+
+    void FieldMap::draw_trail_segment(uint32_t index) {
+      const Point& start = trail[(index - 1) % TRAIL_CAPACITY];
+      const Point& end = trail[index % TRAIL_CAPACITY];
+      pros::screen::set_pen(COLOR_TRAIL);
+      pros::screen::draw_line(start.x, start.y, end.x, end.y);
+    }
+
+    void FieldMap::draw(bool is_full_redraw) {
+      // Falling this far behind means the oldest undrawn points have been
+      // overwritten, so aged out segments can't be found to erase
+      if(trail_count < drawn_trail_count ||
+         trail_count - drawn_trail_count > TRAIL_CAPACITY - TRAIL_LENGTH) {
+        is_full_redraw = true;
+      }
+      const uint32_t first_visible =
+          trail_count > TRAIL_LENGTH ? trail_count - TRAIL_LENGTH : 0;
+
+      if(is_full_redraw) {
+        clear_background();
+        restore(bounds);
+        drawn_trail_count = first_visible;
+        pros::screen::set_pen(COLOR_PATH);
+        for(std::size_t i = 1; i < path_count; i++) {
+          pros::screen::draw_line(path[i - 1].x, path[i - 1].y, path[i].x,
+                                  path[i].y);
+        }
+      } else {
+        // Erase segments that aged out since the last draw, then the robot
+        const uint32_t previous_first =
+            drawn_trail_count > TRAIL_LENGTH ? drawn_trail_count - TRAIL_LENGTH
+                                             : 0;
+        for(uint32_t index = previous_first + 1; index <= first_visible;
+            index++) {
+          const Rect area =
+              get_segment_box(trail[(index - 1) % TRAIL_CAPACITY],
+                              trail[index % TRAIL_CAPACITY]);
+          restore(area);
+          redraw_over(area);
+        }
+        if(drawn_robot_box.x0 <= drawn_robot_box.x1) {
+          restore(drawn_robot_box);
+          redraw_over(drawn_robot_box);
+        }
+      }
+
+      const uint32_t first_new =
+          drawn_trail_count > first_visible ? drawn_trail_count : first_visible;
+      for(uint32_t index = first_new + 1; index < trail_count; index++) {
+        draw_trail_segment(index);
+      }
+      drawn_trail_count = trail_count;
+      draw_robot();
+    }
+
+    void FieldMap::draw_robot() {
+      if(!has_pose) {
+        drawn_robot_box = Rect{0, 0, -1, -1};
+        return;
+      }
+      const double cos_theta = std::cos(robot_theta);
+      const double sin_theta = std::sin(robot_theta);
+      // Screen y points down, so the rotation is mirrored vertically
+      const auto corner = [&](double forward, double left) {
+        return Point{
+            static_cast<int16_t>(std::lround(robot.x + forward * cos_theta -
+                                             left * sin_theta)),
+            static_cast<int16_t>(std::lround(robot.y - forward * sin_theta -
+                                             left * cos_theta))};
+      };
+      const double half = robot_half_size;
+      const Point corners[4] = {corner(half, half), corner(half, -half),
+                                corner(-half, -half), corner(-half, half)};
+      pros::screen::set_pen(COLOR_ROBOT);
+      for(std::size_t i = 0; i < 4; i++) {
+        const Point& start = corners[i];
+        const Point& end = corners[(i + 1) % 4];
+        pros::screen::draw_line(start.x, start.y, end.x, end.y);
+      }
+      const Point front = corner(half, 0.0);
+      pros::screen::draw_line(robot.x, robot.y, front.x, front.y);
+      drawn_robot_box = get_robot_box();
+    }
+  }  // namespace gui
+}  // namespace apollo
@@ -3,5 +3,238 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
-#include "main.h"
 #include "apollo/gui/gui.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "pros/screen.hpp"
+
+apollo::GUI brain_gui;
+
+namespace apollo {
+  void GUI::start(uint32_t period, uint32_t frame_budget) {
+    if(running.exchange(true)) {
+      return;
+    }
+    gui_task = new pros::Task(
+        [this, period, frame_budget] { gui_loop(period, frame_budget); },
+        TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "apollo gui");
+  }
+
+  void GUI::stop() {
+    if(!running.exchange(false)) {
+      return;
+    }
+    gui_task->join();
+    delete gui_task;
+    gui_task = nullptr;
+  }
+
+  bool GUI::is_running() const { return running.load(); }
+
+  bool GUI::add_frame_callback(void (*function)(void* context),
+                               void* context) {
+    if(frame_callback_count == MAX_FRAME_CALLBACKS) {
+      return false;
+    }
+    frame_callbacks[frame_callback_count++] = FrameCallback{function, context};
+    return true;
+  }
+
+  bool GUI::post_text(gui::Label& label, const char* text) {
+    Message message;
+    message.type = MESSAGE_TEXT;
+    message.target = &label;
+    std::strncpy(message.text, text, sizeof(message.text) - 1);
+    message.text[sizeof(message.text) - 1] = '\0';
+    return push(message);
+  }
+
+  bool GUI::post_print(gui::Label& label, const char* format, ...) {
+    Message message;
+    message.type = MESSAGE_TEXT;
+    message.target = &label;
+    va_list arguments;
+    va_start(arguments, format);
+    std::vsnprintf(message.text, sizeof(message.text), format, arguments);
+    va_end(arguments);
+    return push(message);
+  }
+
+  bool GUI::post_value(gui::Bar& bar, double value) {
+    Message message;
+    message.type = MESSAGE_VALUE;
+    message.target = &bar;
+    message.values[0] = value;
+    return push(message);
+  }
+
+  bool GUI::post_samples(gui::Plot& plot,
+                         std::initializer_list<double> values) {
+    Message message;
+    message.type = MESSAGE_SAMPLES;
+    message.target = &plot;
+    message.count = 0;
+    for(double value : values) {
+      if(message.count == gui::Plot::MAX_SERIES) {
+        break;
+      }
+      message.values[message.count++] = value;
+    }
+    return push(message);
+  }
+
+  bool GUI::post_pose(gui::FieldMap& map, const Pose& pose) {
+    Message message;
+    message.type = MESSAGE_POSE;
+    message.target = &map;
+    message.values[0] = pose.x.getValue();
+    message.values[1] = pose.y.getValue();
+    message.values[2] = pose.theta.getValue();
+    return push(message);
+  }
+
+  bool GUI::post_page(gui::Page& page) {
+    Message message;
+    message.type = MESSAGE_PAGE;
+    message.target = &page;
+    return push(message);
+  }
+
+  bool GUI::post(void (*function)(void* context), void* context) {
+    Message message;
+    message.type = MESSAGE_CALLBACK;
+    message.target = context;
+    message.function = function;
+    return push(message);
+  }
+
+  bool GUI::push(const Message& message) { return queue.push(message); }
+
+  void GUI::gui_loop(uint32_t period, uint32_t frame_budget) {
+    uint32_t wake_time = pros::millis();
+    while(running.load()) {
+      Message message;
+      while(queue.pop(message)) {
+        apply(message);
+      }
+      for(std::size_t i = 0; i < frame_callback_count; i++) {
+        frame_callbacks[i].function(frame_callbacks[i].context);
+      }
+      update(frame_budget);
+      pros::Task::delay_until(&wake_time, period);
+    }
+  }
+
+  void GUI::apply(const Message& message) {
+    switch(message.type) {
+      case MESSAGE_TEXT:
+        static_cast<gui::Label*>(message.target)->set_text(message.text);
+        break;
+      case MESSAGE_VALUE:
+        static_cast<gui::Bar*>(message.target)->set_value(message.values[0]);
+        break;
+      case MESSAGE_SAMPLES:
+        static_cast<gui::Plot*>(message.target)
+            ->push(message.values, message.count);
+        break;
+      case MESSAGE_POSE: {
+        Pose pose;
+        pose.x = units::QLength(message.values[0]);
+        pose.y = units::QLength(message.values[1]);
+        pose.theta = units::QAngle(message.values[2]);
+        static_cast<gui::FieldMap*>(message.target)->set_pose(pose);
+        break;
+      }
+      case MESSAGE_PAGE:
+        set_page(*static_cast<gui::Page*>(message.target));
+        break;
+      case MESSAGE_AUTON:
+        apply_auton_selection(static_cast<int>(message.values[0]),
+                              static_cast<field_side>(message.values[1]));
+        break;
+      case MESSAGE_CALLBACK:
+        message.function(message.target);
+        break;
+    }
+  }
+
+  void GUI::set_page(gui::Page& page) {
+    this->page = &page;
+    page.invalidate();
+    needs_clear = true;
+    next_widget = 0;
+  }
+
+  gui::Page* GUI::get_page() const { return page; }
+
+  void GUI::set_background(uint32_t color) {
+    background = color;
+    needs_clear = true;
+    if(page != nullptr) {
+      page->invalidate();
+    }
+  }
+
+  std::size_t GUI::update(uint32_t frame_budget) {
+    if(page == nullptr) {
+      return 0;
+    }
+    dispatch_touch();
+
+    const uint32_t start = pros::micros();
+    if(needs_clear) {
+      pros::screen::set_eraser(background);
+      pros::screen::erase();
+      needs_clear = false;
+    }
+    // Resume where the last update ran out of budget, so widgets late in the
+    // page are not starved by ones early in it that change every tick
+    std::size_t drawn = 0;
+    const std::size_t widget_count = page->size();
+    for(std::size_t i = 0; i < widget_count; i++) {
+      const std::size_t index = (next_widget + i) % widget_count;
+      gui::Widget& widget = page->get_widget(index);
+      if(!widget.is_dirty()) {
+        continue;
+      }
+      if(drawn > 0 && pros::micros() - start >= frame_budget) {
+        next_widget = index;
+        return drawn;
+      }
+      widget.render();
+      drawn++;
+    }
+    next_widget = 0;
+    return drawn;
+  }
+
+  void GUI::dispatch_touch() {
+    const pros::screen_touch_status_s_t status = pros::screen::touch_status();
+    pros::last_touch_e_t event;
+    if(status.press_count != press_count) {
+      event = pros::E_TOUCH_PRESSED;
+    } else if(status.release_count != release_count) {
+      event = pros::E_TOUCH_RELEASED;
+    } else {
+      return;
+    }
+    // A tap shorter than an update shows up as both counts changing at once
+    const bool is_tap = status.press_count != press_count &&
+                        status.release_count != release_count;
+    press_count = status.press_count;
+    release_count = status.release_count;
+    for(std::size_t i = 0; i < page->size(); i++) {
+      gui::Widget& widget = page->get_widget(i);
+      const bool is_handled = widget.touch(status.x, status.y, event);
+      if(is_tap) {
+        widget.touch(status.x, status.y, pros::E_TOUCH_RELEASED);
+      }
+      if(is_handled) {
+        break;
+      }
+    }
+  }
+}  // namespace apollo
@@ -0,0 +1,176 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/motorDashboard.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "pros/error.h"
+#include "pros/motors.h"
+
+namespace apollo {
+  namespace gui {
+    namespace {
+      constexpr std::size_t ROWS_PER_COLUMN = MotorDashboard::MAX_MOTORS / 2;
+      constexpr int16_t ROW_TOP = 24;
+      constexpr int16_t ROW_HEIGHT = 21;
+      constexpr uint32_t COLOR_ALERT = static_cast<uint32_t>(pros::Color::red);
+    }  // namespace
+
+    MotorDashboard::MotorDashboard(uint32_t period)
+        : period(period),
+          title({0, 0, 479, ROW_TOP - 2}, "Motors", pros::E_TEXT_MEDIUM) {
+      page.add(title);
+    }
+
+    MotorDashboard::~MotorDashboard() { stop(); }
+
+    bool MotorDashboard::add_motor(const char* name, int8_t port,
+                                   pros::MotorGears cartridge) {
+      if(motor_count == MAX_MOTORS) {
+        return false;
+      }
+      motor& added = motors[motor_count];
+      std::strncpy(added.name, name, MOTOR_NAME_SIZE - 1);
+      added.name[MOTOR_NAME_SIZE - 1] = '\0';
+      added.is_reversed = port < 0;
+      added.port = static_cast<int8_t>(port < 0 ? -port : port);
+      added.cartridge = cartridge;
+
+      const int16_t column = motor_count / ROWS_PER_COLUMN;
+      const int16_t row = motor_count % ROWS_PER_COLUMN;
+      const int16_t x0 = column * (SCREEN_WIDTH / 2);
+      const int16_t y0 = ROW_TOP + row * ROW_HEIGHT;
+      rows[motor_count].set_bounds(
+          {x0, y0, static_cast<int16_t>(x0 + SCREEN_WIDTH / 2 - 1),
+           static_cast<int16_t>(y0 + ROW_HEIGHT - 1)});
+      rows[motor_count].print("%-6.6s %2d  --", added.name, added.port);
+      page.add(rows[motor_count]);
+      motor_count++;
+      return true;
+    }
+
+    std::size_t MotorDashboard::get_motor_count() const { return motor_count; }
+
+    const motor& MotorDashboard::get_motor(std::size_t index) const {
+      return motors[index];
+    }
+
+    MotorSnapshot MotorDashboard::get_snapshot(std::size_t index) const {
+      if(index >= motor_count) {
+        return MotorSnapshot();
+      }
+      snapshot_mutex.take();
+      const MotorSnapshot result = snapshot[index];
+      snapshot_mutex.give();
+      return result;
+    }
+
+    void MotorDashboard::start() {
+      if(running.exchange(true)) {
+        return;
+      }
+      sample_task =
+          new pros::Task([this] { sample_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo motor dashboard");
+    }
+
+    void MotorDashboard::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      sample_task->join();
+      delete sample_task;
+      sample_task = nullptr;
+    }
+
+    Page& MotorDashboard::get_page() { return page; }
+
+    void MotorDashboard::sample_loop() {
+      uint32_t wake_time = pros::millis();
+      while(running.load()) {
+        sample();
+        pros::Task::delay_until(&wake_time, period);
+      }
+    }
+
+    void MotorDashboard::sample() {
+      // Read every motor before taking the lock, so refresh() never waits on
+      // the device reads
+      MotorSnapshot samples[MAX_MOTORS];
+      for(std::size_t i = 0; i < motor_count; i++) {
+        const int8_t port = motors[i].port;
+        MotorSnapshot& sample = samples[i];
+        const double temperature = pros::c::motor_get_temperature(port);
+        sample.is_connected = temperature != PROS_ERR_F;
+        if(!sample.is_connected) {
+          continue;
+        }
+        sample.temperature = static_cast<float>(temperature);
+        sample.current = pros::c::motor_get_current_draw(port);
+        sample.velocity =
+            static_cast<float>(pros::c::motor_get_actual_velocity(port));
+        sample.faults = pros::c::motor_get_faults(port);
+      }
+
+      snapshot_mutex.take();
+      for(std::size_t i = 0; i < motor_count; i++) {
+        snapshot[i] = samples[i];
+      }
+      snapshot_count++;
+      snapshot_mutex.give();
+    }
+
+    void MotorDashboard::refresh() {
+      MotorSnapshot samples[MAX_MOTORS];
+      snapshot_mutex.take();
+      const uint32_t count = snapshot_count;
+      if(count != shown_snapshot_count) {
+        for(std::size_t i = 0; i < motor_count; i++) {
+          samples[i] = snapshot[i];
+        }
+      }
+      snapshot_mutex.give();
+      if(count == shown_snapshot_count) {
+        return;
+      }
+      shown_snapshot_count = count;
+
+      for(std::size_t i = 0; i < motor_count; i++) {
+        const motor& shown = motors[i];
+        const MotorSnapshot& sample = samples[i];
+        Label& row = rows[i];
+        if(!sample.is_connected) {
+          row.print("%-6.6s %2d  --", shown.name, shown.port);
+        } else {
+          char faults[4] = "";
+          std::size_t fault_count = 0;
+          if(sample.faults & pros::E_MOTOR_FAULT_MOTOR_OVER_TEMP) {
+            faults[fault_count++] = 'T';
+          }
+          if(sample.faults & pros::E_MOTOR_FAULT_DRIVER_FAULT) {
+            faults[fault_count++] = 'D';
+          }
+          if(sample.faults & (pros::E_MOTOR_FAULT_OVER_CURRENT |
+                              pros::E_MOTOR_FAULT_DRV_OVER_CURRENT)) {
+            faults[fault_count++] = 'C';
+          }
+          faults[fault_count] = '\0';
+          row.print("%-6.6s %2d %2.0fC %3.1fA %4.0f %s", shown.name,
+                    shown.port, sample.temperature, sample.current / 1000.0,
+                    sample.velocity, faults);
+        }
+        // Changing colors redraws the row, so only do it when the state flips
+        const bool is_alert = !sample.is_connected || sample.faults != 0;
+        if(is_alert != is_row_alert[i]) {
+          is_row_alert[i] = is_alert;
+          row.set_colors(COLOR_FOREGROUND,
+                         is_alert ? COLOR_ALERT : COLOR_BACKGROUND);
+        }
+      }
+    }
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,160 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/plot.hpp"
+
+#include "pros/screen.hpp"
+
+namespace apollo {
+  namespace gui {
+    Plot::Plot(Rect bounds, double minimum, double maximum,
+               std::size_t samples_per_column)
+        : Widget(bounds),
+          minimum(minimum),
+          maximum(maximum),
+          samples_per_column(samples_per_column > 0 ? samples_per_column : 1),
+          column_capacity(bounds.get_width() > static_cast<int16_t>(MAX_COLUMNS)
+                              ? MAX_COLUMNS
+                              : static_cast<std::size_t>(bounds.get_width())) {}
+
+    bool Plot::add_series(uint32_t color) {
+      if(series_count == MAX_SERIES) {
+        return false;
+      }
+      Series& added = series[series_count++];
+      added.color = color;
+      added.pending = EMPTY_COLUMN;
+      for(Column& column : added.columns) {
+        column = EMPTY_COLUMN;
+      }
+      invalidate();
+      return true;
+    }
+
+    void Plot::push(std::initializer_list<double> values) {
+      push(values.begin(), values.size());
+    }
+
+    void Plot::push(const double* values, std::size_t count) {
+      for(std::size_t index = 0; index < count && index < series_count;
+          index++) {
+        Column& pending = series[index].pending;
+        const float sample = static_cast<float>(values[index]);
+        if(pending.is_empty) {
+          pending = Column{sample, sample, false};
+        } else if(sample < pending.minimum) {
+          pending.minimum = sample;
+        } else if(sample > pending.maximum) {
+          pending.maximum = sample;
+        }
+      }
+      if(++pending_samples < samples_per_column) {
+        return;
+      }
+      // The column is complete: store it and draw it on the next render
+      pending_samples = 0;
+      const std::size_t slot = column_count % column_capacity;
+      for(std::size_t i = 0; i < series_count; i++) {
+        series[i].columns[slot] = series[i].pending;
+        series[i].pending = EMPTY_COLUMN;
+      }
+      column_count++;
+      mark_dirty();
+    }
+
+    void Plot::clear() {
+      for(std::size_t i = 0; i < series_count; i++) {
+        series[i].pending = EMPTY_COLUMN;
+      }
+      pending_samples = 0;
+      column_count = 0;
+      invalidate();
+    }
+
+    void Plot::set_range(double minimum, double maximum) {
+      this->minimum = minimum;
+      this->maximum = maximum;
+      invalidate();
+    }
+
+    void Plot::set_samples_per_column(std::size_t samples_per_column) {
+      this->samples_per_column =
+          samples_per_column > 0 ? samples_per_column : 1;
+      clear();
+    }
+
+    int16_t Plot::to_y(float value) const {
+      if(maximum <= minimum) {
+        return bounds.y1;
+      }
+      double fraction = (value - minimum) / (maximum - minimum);
+      if(fraction < 0.0) {
+        fraction = 0.0;
+      } else if(fraction > 1.0) {
+        fraction = 1.0;
+      }
+      return static_cast<int16_t>(bounds.y1 -
+                                  fraction * (bounds.get_height() - 1));
+    }
+
+    void Plot::draw(bool is_full_redraw) {
+      // Columns older than one sweep have been overwritten
+      uint32_t first = drawn_column_count;
+      if(is_full_redraw || column_count < drawn_column_count) {
+        clear_background();
+        first = 0;
+      }
+      if(column_count - first > column_capacity) {
+        first = column_count - column_capacity;
+      }
+      for(uint32_t index = first; index < column_count; index++) {
+        draw_column(index);
+      }
+      draw_cursor(column_count);
+      drawn_column_count = column_count;
+    }
+
+    void Plot::draw_column(uint32_t index) {
+      const int16_t x =
+          bounds.x0 + static_cast<int16_t>(index % column_capacity);
+      pros::screen::set_pen(background);
+      pros::screen::draw_line(x, bounds.y0, x, bounds.y1);
+      const std::size_t slot = index % column_capacity;
+      // Wrapping back to the left edge would join the last column to the
+      // first, so that column only draws its own range
+      const bool has_previous = index > 0 && slot > 0;
+      const std::size_t previous_slot =
+          (index + column_capacity - 1) % column_capacity;
+      for(std::size_t i = 0; i < series_count; i++) {
+        const Column& column = series[i].columns[slot];
+        if(column.is_empty) {
+          continue;
+        }
+        // Stretch the column to meet the previous one, so a steep change
+        // draws as a connected line instead of separate dots
+        float low = column.minimum;
+        float high = column.maximum;
+        const Column& previous = series[i].columns[previous_slot];
+        if(has_previous && !previous.is_empty) {
+          if(previous.maximum < low) {
+            low = previous.maximum;
+          }
+          if(previous.minimum > high) {
+            high = previous.minimum;
+          }
+        }
+        pros::screen::set_pen(series[i].color);
+        pros::screen::draw_line(x, to_y(high), x, to_y(low));
+      }
+    }
+
+    void Plot::draw_cursor(uint32_t index) {
+      const int16_t x =
+          bounds.x0 + static_cast<int16_t>(index % column_capacity);
+      pros::screen::set_pen(COLOR_MUTED);
+      pros::screen::draw_line(x, bounds.y0, x, bounds.y1);
+    }
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,325 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/preflightCheck.hpp"
+
+#include <cmath>
+
+#include "pros/adi.h"
+#include "pros/device.hpp"
+#include "pros/error.h"
+#include "pros/ext_adi.h"
+#include "pros/imu.h"
+#include "pros/misc.hpp"
+
+namespace apollo {
+  namespace gui {
+    namespace {
+      constexpr std::size_t ROWS_PER_COLUMN = 10;
+      constexpr int16_t ROW_TOP = 24;
+      constexpr int16_t ROW_HEIGHT = 21;
+      constexpr uint32_t COLOR_FAILED = static_cast<uint32_t>(pros::Color::red);
+      constexpr uint32_t COLOR_WARNING =
+          static_cast<uint32_t>(pros::Color::dark_orange);
+
+      Rect get_row_bounds(std::size_t row) {
+        const int16_t column = row / ROWS_PER_COLUMN;
+        const int16_t x0 = column * (SCREEN_WIDTH / 2);
+        const int16_t y0 = ROW_TOP + (row % ROWS_PER_COLUMN) * ROW_HEIGHT;
+        return Rect{x0, y0, static_cast<int16_t>(x0 + SCREEN_WIDTH / 2 - 1),
+                    static_cast<int16_t>(y0 + ROW_HEIGHT - 1)};
+      }
+
+      const char* get_device_name(chassis_device_type type) {
+        switch(type) {
+          case CHASSIS_DEVICE_MOTOR:
+            return "motor";
+          case CHASSIS_DEVICE_IMU:
+            return "IMU";
+          case CHASSIS_DEVICE_ROTATION:
+            return "rotation";
+          case CHASSIS_DEVICE_ADI_ENCODER:
+            return "encoder";
+        }
+        return "";
+      }
+
+      pros::DeviceType get_expected_type(chassis_device_type type) {
+        switch(type) {
+          case CHASSIS_DEVICE_MOTOR:
+            return pros::DeviceType::motor;
+          case CHASSIS_DEVICE_IMU:
+            return pros::DeviceType::imu;
+          case CHASSIS_DEVICE_ROTATION:
+            return pros::DeviceType::rotation;
+          case CHASSIS_DEVICE_ADI_ENCODER:
+            return pros::DeviceType::adi;
+        }
+        return pros::DeviceType::undefined;
+      }
+
+      void set_row_colors(Label& row, preflight_status status) {
+        switch(status) {
+          case PREFLIGHT_PENDING:
+            row.set_colors(COLOR_MUTED, COLOR_BACKGROUND);
+            break;
+          case PREFLIGHT_OK:
+            row.set_colors(COLOR_FOREGROUND, COLOR_BACKGROUND);
+            break;
+          case PREFLIGHT_WARNING:
+            row.set_colors(COLOR_FOREGROUND, COLOR_WARNING);
+            break;
+          case PREFLIGHT_FAILED:
+            row.set_colors(COLOR_FOREGROUND, COLOR_FAILED);
+            break;
+        }
+      }
+
+      void print_row(Label& row, const chassis_device& device,
+                     const char* detail) {
+        const char* name = get_device_name(device.type);
+        if(device.type != CHASSIS_DEVICE_ADI_ENCODER) {
+          row.print("%-8s %2d   %s", name, device.port, detail);
+        } else if(device.port == INTERNAL_ADI_PORT) {
+          row.print("%-8s    %c  %s", name, 'A' + device.adi_port - 1, detail);
+        } else {
+          row.print("%-8s %2d %c  %s", name, device.port,
+                    'A' + device.adi_port - 1, detail);
+        }
+      }
+
+      PreflightResult probe_device(const chassis_device& device) {
+        // The brain's own ADI ports are always there, and the ADI can't
+        // sense whether an encoder is plugged in, so only its setup is
+        // checked
+        if(device.type == CHASSIS_DEVICE_ADI_ENCODER &&
+           device.port == INTERNAL_ADI_PORT) {
+          return pros::c::adi_port_get_config(device.adi_port) ==
+                         pros::E_ADI_LEGACY_ENCODER
+                     ? PreflightResult{PREFLIGHT_OK, "configured"}
+                     : PreflightResult{PREFLIGHT_FAILED, "not configured"};
+        }
+
+        const pros::DeviceType plugged =
+            pros::Device(device.port).get_plugged_type();
+        if(plugged == pros::DeviceType::none) {
+          return {PREFLIGHT_FAILED, "missing"};
+        }
+        if(plugged != get_expected_type(device.type)) {
+          return {PREFLIGHT_FAILED, "wrong device"};
+        }
+
+        if(device.type == CHASSIS_DEVICE_ADI_ENCODER) {
+          return pros::c::ext_adi_port_get_config(device.port,
+                                                  device.adi_port) ==
+                         pros::E_ADI_LEGACY_ENCODER
+                     ? PreflightResult{PREFLIGHT_OK, "ok"}
+                     : PreflightResult{PREFLIGHT_FAILED, "not configured"};
+        }
+        if(device.type == CHASSIS_DEVICE_IMU) {
+          const pros::imu_status_e_t status =
+              pros::c::imu_get_status(device.port);
+          if(status == pros::E_IMU_STATUS_ERROR) {
+            return {PREFLIGHT_FAILED, "error"};
+          }
+          if(status & pros::E_IMU_STATUS_CALIBRATING) {
+            return {PREFLIGHT_PENDING, "calibrating"};
+          }
+        }
+        return {PREFLIGHT_OK, "ok"};
+      }
+    }  // namespace
+
+    PreflightCheck::PreflightCheck(double minimum_battery, uint32_t period)
+        : minimum_battery(minimum_battery),
+          period(period),
+          title({0, 0, 479, ROW_TOP - 2}, "Preflight  checking",
+                pros::E_TEXT_MEDIUM),
+          battery_row(get_row_bounds(0), "battery  --") {
+      page.add(title);
+      set_row_colors(battery_row, PREFLIGHT_PENDING);
+      page.add(battery_row);
+    }
+
+    PreflightCheck::~PreflightCheck() { stop(); }
+
+    bool PreflightCheck::add_chassis(const ChassisModel& chassis) {
+      bool is_added = true;
+      for(std::size_t i = 0; i < chassis.get_device_count(); i++) {
+        is_added = add_device(chassis.get_device(i)) && is_added;
+      }
+      return is_added;
+    }
+
+    bool PreflightCheck::add_device(const chassis_device& device) {
+      if(device_count == MAX_DEVICES) {
+        return false;
+      }
+      devices[device_count] = device;
+      Label& row = rows[device_count];
+      // Row 0 is the battery
+      row.set_bounds(get_row_bounds(device_count + 1));
+      print_row(row, device, "--");
+      set_row_colors(row, PREFLIGHT_PENDING);
+      page.add(row);
+      device_count++;
+      return true;
+    }
+
+    std::size_t PreflightCheck::get_device_count() const {
+      return device_count;
+    }
+
+    void PreflightCheck::start() {
+      if(running.exchange(true)) {
+        return;
+      }
+      probe_task =
+          new pros::Task([this] { probe_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo preflight");
+    }
+
+    void PreflightCheck::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      probe_task->join();
+      delete probe_task;
+      probe_task = nullptr;
+    }
+
+    PreflightResult PreflightCheck::get_result(std::size_t index) const {
+      if(index >= device_count) {
+        return PreflightResult();
+      }
+      result_mutex.take();
+      const PreflightResult result = results[index];
+      result_mutex.give();
+      return result;
+    }
+
+    PreflightResult PreflightCheck::get_battery_result() const {
+      result_mutex.take();
+      const PreflightResult result = battery_result;
+      result_mutex.give();
+      return result;
+    }
+
+    bool PreflightCheck::is_complete() const {
+      result_mutex.take();
+      bool is_pending = pass_count == 0 ||
+                        battery_result.status == PREFLIGHT_PENDING;
+      for(std::size_t i = 0; i < device_count && !is_pending; i++) {
+        is_pending = results[i].status == PREFLIGHT_PENDING;
+      }
+      result_mutex.give();
+      return !is_pending;
+    }
+
+    std::size_t PreflightCheck::get_failure_count() const {
+      result_mutex.take();
+      std::size_t failures =
+          battery_result.status == PREFLIGHT_FAILED ? 1 : 0;
+      for(std::size_t i = 0; i < device_count; i++) {
+        if(results[i].status == PREFLIGHT_FAILED) {
+          failures++;
+        }
+      }
+      result_mutex.give();
+      return failures;
+    }
+
+    Page& PreflightCheck::get_page() { return page; }
+
+    void PreflightCheck::probe_loop() {
+      uint32_t wake_time = pros::millis();
+      while(running.load()) {
+        probe();
+        pros::Task::delay_until(&wake_time, period);
+      }
+    }
+
+    void PreflightCheck::probe() {
+      // Probe every port before taking the lock, so refresh() never waits
+      // on the device reads
+      PreflightResult probed[MAX_DEVICES];
+      for(std::size_t i = 0; i < device_count; i++) {
+        probed[i] = probe_device(devices[i]);
+      }
+      const double capacity = pros::battery::get_capacity();
+      PreflightResult battery;
+      if(capacity == PROS_ERR_F) {
+        battery = PreflightResult{PREFLIGHT_WARNING, "unknown"};
+      } else if(capacity < minimum_battery) {
+        battery = PreflightResult{PREFLIGHT_FAILED, "low"};
+      } else {
+        battery = PreflightResult{PREFLIGHT_OK, "ok"};
+      }
+
+      result_mutex.take();
+      for(std::size_t i = 0; i < device_count; i++) {
+        results[i] = probed[i];
+      }
+      battery_result = battery;
+      battery_capacity = capacity;
+      pass_count++;
+      result_mutex.give();
+    }
+
+    void PreflightCheck::refresh() {
+      PreflightResult probed[MAX_DEVICES];
+      PreflightResult battery;
+      double capacity = 0.0;
+      result_mutex.take();
+      const uint32_t count = pass_count;
+      if(count != shown_pass_count) {
+        for(std::size_t i = 0; i < device_count; i++) {
+          probed[i] = results[i];
+        }
+        battery = battery_result;
+        capacity = battery_capacity;
+      }
+      result_mutex.give();
+      if(count == shown_pass_count) {
+        return;
+      }
+      shown_pass_count = count;
+
+      // Labels skip redraws when their text is unchanged, and colors are
+      // only set when a row's status flips
+      std::size_t failures = 0;
+      std::size_t pending = 0;
+      if(battery.status == PREFLIGHT_WARNING) {
+        battery_row.print("battery  --   %s", battery.detail);
+      } else {
+        battery_row.print("battery  %3.0f%% %s", capacity, battery.detail);
+      }
+      if(battery.status != shown_status[0]) {
+        shown_status[0] = battery.status;
+        set_row_colors(battery_row, battery.status);
+      }
+      failures += battery.status == PREFLIGHT_FAILED ? 1 : 0;
+      for(std::size_t i = 0; i < device_count; i++) {
+        const PreflightResult& result = probed[i];
+        print_row(rows[i], devices[i], result.detail);
+        if(result.status != shown_status[i + 1]) {
+          shown_status[i + 1] = result.status;
+          set_row_colors(rows[i], result.status);
+        }
+        failures += result.status == PREFLIGHT_FAILED ? 1 : 0;
+        pending += result.status == PREFLIGHT_PENDING ? 1 : 0;
+      }
+
+      if(failures > 0) {
+        title.print("Preflight  %d problem%s", static_cast<int>(failures),
+                    failures == 1 ? "" : "s");
+      } else if(pending > 0) {
+        title.set_text("Preflight  checking");
+      } else {
+        title.set_text("Preflight  all OK");
+      }
+    }
+  }  // namespace gui
+}  // namespace apollo
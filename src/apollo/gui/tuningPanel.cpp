@@ -0,0 +1,230 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/tuningPanel.hpp"
+
+#include "pros/misc.hpp"
+
+namespace apollo {
+  namespace gui {
+    namespace {
+      constexpr int PAGE_SIZE = static_cast<int>(TuningPanel::ROWS_PER_PAGE);
+
+      constexpr int16_t row_top(std::size_t row) {
+        return static_cast<int16_t>(28 + row * 44);
+      }
+    }  // namespace
+
+    TuningPanel::TuningPanel(ParameterRegistry& registry, const char* path)
+        : registry(registry),
+          path(path),
+          title({0, 0, 299, 23}, "", pros::E_TEXT_MEDIUM),
+          status({300, 0, 479, 23}),
+          previous_page({0, 208, 109, 239}, "<", on_previous_page_pressed,
+                        this),
+          next_page({120, 208, 229, 239}, ">", on_next_page_pressed, this),
+          load_button({240, 208, 354, 239}, "Load", on_load_pressed, this),
+          save_button({365, 208, 479, 239}, "Save", on_save_pressed, this) {
+      page.add(title);
+      page.add(status);
+      for(std::size_t i = 0; i < ROWS_PER_PAGE; i++) {
+        Row& row = rows[i];
+        const int16_t top = row_top(i);
+        row.name.set_bounds({0, top, 179, static_cast<int16_t>(top + 19)});
+        row.value.set_bounds({0, static_cast<int16_t>(top + 20), 179,
+                              static_cast<int16_t>(top + 39)});
+        row.decrease.set_bounds(
+            {184, top, 227, static_cast<int16_t>(top + 39)});
+        row.slider.set_bounds({232, static_cast<int16_t>(top + 8), 427,
+                               static_cast<int16_t>(top + 31)});
+        row.increase.set_bounds(
+            {432, top, 479, static_cast<int16_t>(top + 39)});
+        page.add(row.name);
+        page.add(row.value);
+        page.add(row.decrease);
+        page.add(row.slider);
+        page.add(row.increase);
+      }
+      rows[0].decrease.set_callback(on_decrease_pressed<0>, this);
+      rows[1].decrease.set_callback(on_decrease_pressed<1>, this);
+      rows[2].decrease.set_callback(on_decrease_pressed<2>, this);
+      rows[3].decrease.set_callback(on_decrease_pressed<3>, this);
+      rows[0].increase.set_callback(on_increase_pressed<0>, this);
+      rows[1].increase.set_callback(on_increase_pressed<1>, this);
+      rows[2].increase.set_callback(on_increase_pressed<2>, this);
+      rows[3].increase.set_callback(on_increase_pressed<3>, this);
+      page.add(previous_page);
+      page.add(next_page);
+      page.add(load_button);
+      page.add(save_button);
+      show_page(0);
+    }
+
+    void TuningPanel::set_change_callback(TuningCallback callback,
+                                          void* context) {
+      change_callback = callback;
+      change_context = context;
+    }
+
+    bool TuningPanel::load() {
+      const bool is_loaded = registry.load(path);
+      if(change_callback != nullptr) {
+        change_callback(change_context);
+      }
+      if(is_loaded) {
+        status.set_text(registry.is_truncated() ? "Loaded, file cut short"
+                                                : "Loaded");
+      } else {
+        status.set_text(pros::usd::is_installed() ? "No saved values"
+                                                  : "No SD card");
+      }
+      return is_loaded;
+    }
+
+    bool TuningPanel::save() {
+      const bool is_saved = pros::usd::is_installed() && registry.save(path);
+      status.set_text(is_saved ? "Saved" : "Not saved");
+      return is_saved;
+    }
+
+    Page& TuningPanel::get_page() { return page; }
+
+    void TuningPanel::refresh() {
+      // Parameters are never removed, so a page that was short may have
+      // gained rows since it was shown
+      for(std::size_t i = 0; i < ROWS_PER_PAGE; i++) {
+        const int index = get_parameter(i);
+        if(index < 0) {
+          continue;
+        }
+        if(rows[i].name.get_text()[0] == '\0') {
+          show_page(current_page);
+          return;
+        }
+        if(registry.get_value(index) != rows[i].shown_value) {
+          show_value(i);
+        }
+      }
+    }
+
+    int TuningPanel::get_page_count() const {
+      const int count = static_cast<int>(registry.size());
+      return count == 0 ? 1 : (count + PAGE_SIZE - 1) / PAGE_SIZE;
+    }
+
+    int TuningPanel::get_parameter(std::size_t row) const {
+      const int index = current_page * PAGE_SIZE + static_cast<int>(row);
+      return index < static_cast<int>(registry.size()) ? index : -1;
+    }
+
+    void TuningPanel::show_page(int page) {
+      const int page_count = get_page_count();
+      current_page = (page % page_count + page_count) % page_count;
+      title.print("Tuning  %d/%d", current_page + 1, page_count);
+      for(std::size_t i = 0; i < ROWS_PER_PAGE; i++) {
+        Row& row = rows[i];
+        const int index = get_parameter(i);
+        if(index < 0) {
+          // Rows past the last parameter are drawn in the background color
+          row.name.set_text("");
+          row.value.set_text("");
+          row.slider.set_callback(nullptr, nullptr);
+          row.slider.set_range(0.0, 1.0);
+          row.slider.set_value(0.0);
+          row.slider.set_colors(COLOR_BACKGROUND, COLOR_BACKGROUND);
+          row.decrease.set_colors(COLOR_BACKGROUND, COLOR_BACKGROUND);
+          row.increase.set_colors(COLOR_BACKGROUND, COLOR_BACKGROUND);
+          continue;
+        }
+        const ParameterEntry& entry = registry.get_entry(index);
+        row.name.set_text(entry.name);
+        row.slider.set_range(entry.minimum / entry.unit,
+                             entry.maximum / entry.unit);
+        row.slider.set_colors(COLOR_FOREGROUND, COLOR_BACKGROUND);
+        row.decrease.set_colors(COLOR_FOREGROUND, COLOR_BACKGROUND);
+        row.increase.set_colors(COLOR_FOREGROUND, COLOR_BACKGROUND);
+        show_value(i);
+      }
+      // Slider callbacks are only set on rows that show a parameter
+      rows[0].slider.set_callback(
+          get_parameter(0) < 0 ? nullptr : on_slider_moved<0>, this);
+      rows[1].slider.set_callback(
+          get_parameter(1) < 0 ? nullptr : on_slider_moved<1>, this);
+      rows[2].slider.set_callback(
+          get_parameter(2) < 0 ? nullptr : on_slider_moved<2>, this);
+      rows[3].slider.set_callback(
+          get_parameter(3) < 0 ? nullptr : on_slider_moved<3>, this);
+    }
+
+    void TuningPanel::show_value(std::size_t row) {
+      const int index = get_parameter(row);
+      if(index < 0) {
+        return;
+      }
+      Row& shown = rows[row];
+      char text[Label::TEXT_SIZE];
+      registry.format_value(index, text, sizeof(text));
+      shown.shown_value = registry.get_value(index);
+      shown.value.set_text(text);
+      shown.slider.set_value(shown.shown_value);
+    }
+
+    void TuningPanel::changed(std::size_t row) {
+      // Redraws the slider at the value the registry clamped and rounded to
+      show_value(row);
+      status.set_text("Not saved");
+      if(change_callback != nullptr) {
+        change_callback(change_context);
+      }
+    }
+
+    template <int ROW>
+    void TuningPanel::on_decrease_pressed(void* context) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      const int index = self.get_parameter(ROW);
+      if(index >= 0 && self.registry.step_value(index, -1)) {
+        self.changed(ROW);
+      }
+    }
+
+    template <int ROW>
+    void TuningPanel::on_increase_pressed(void* context) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      const int index = self.get_parameter(ROW);
+      if(index >= 0 && self.registry.step_value(index, 1)) {
+        self.changed(ROW);
+      }
+    }
+
+    template <int ROW>
+    void TuningPanel::on_slider_moved(void* context, double value) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      const int index = self.get_parameter(ROW);
+      if(index >= 0 && self.registry.set_value(index, value)) {
+        self.changed(ROW);
+      }
+    }
+
+    void TuningPanel::on_previous_page_pressed(void* context) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      self.show_page(self.current_page - 1);
+    }
+
+    void TuningPanel::on_next_page_pressed(void* context) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      self.show_page(self.current_page + 1);
+    }
+
+    void TuningPanel::on_load_pressed(void* context) {
+      TuningPanel& self = *static_cast<TuningPanel*>(context);
+      self.load();
+      self.show_page(self.current_page);
+    }
+
+    void TuningPanel::on_save_pressed(void* context) {
+      static_cast<TuningPanel*>(context)->save();
+    }
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,292 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/gui/widget.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "pros/screen.hpp"
+
+namespace apollo {
+  namespace gui {
+    namespace {
+      // Text is inset from the widget edge by this many pixels
+      constexpr int16_t TEXT_PADDING = 4;
+
+      bool copy_text(char* destination, const char* text, std::size_t size) {
+        if(std::strncmp(destination, text, size - 1) == 0) {
+          return false;
+        }
+        std::strncpy(destination, text, size - 1);
+        destination[size - 1] = '\0';
+        return true;
+      }
+    }  // namespace
+
+    Widget::Widget(Rect bounds) : bounds(bounds) {}
+
+    const Rect& Widget::get_bounds() const { return bounds; }
+
+    void Widget::set_bounds(Rect bounds) {
+      this->bounds = bounds;
+      invalidate();
+    }
+
+    void Widget::set_colors(uint32_t foreground, uint32_t background) {
+      this->foreground = foreground;
+      this->background = background;
+      invalidate();
+    }
+
+    bool Widget::is_dirty() const { return dirty; }
+
+    void Widget::mark_dirty() { dirty = true; }
+
+    void Widget::invalidate() {
+      dirty = true;
+      needs_full_redraw = true;
+    }
+
+    void Widget::render() {
+      if(!dirty) {
+        return;
+      }
+      draw(needs_full_redraw);
+      dirty = false;
+      needs_full_redraw = false;
+    }
+
+    bool Widget::touch(int16_t, int16_t, pros::last_touch_e_t) { return false; }
+
+    void Widget::clear_background() const { clear_area(bounds); }
+
+    void Widget::clear_area(const Rect& area) const {
+      pros::screen::set_pen(background);
+      pros::screen::fill_rect(area.x0, area.y0, area.x1, area.y1);
+    }
+
+    Label::Label(Rect bounds, const char* text,
+                 pros::text_format_e_t text_format)
+        : Widget(bounds), text_format(text_format) {
+      this->text[0] = '\0';
+      copy_text(this->text, text, sizeof(this->text));
+    }
+
+    void Label::set_text(const char* text) {
+      if(copy_text(this->text, text, sizeof(this->text))) {
+        mark_dirty();
+      }
+    }
+
+    void Label::print(const char* format, ...) {
+      char formatted[TEXT_SIZE];
+      va_list arguments;
+      va_start(arguments, format);
+      std::vsnprintf(formatted, sizeof(formatted), format, arguments);
+      va_end(arguments);
+      set_text(formatted);
+    }
+
+    const char* Label::get_text() const { return text; }
+
+    void Label::draw(bool) {
+      // Text of different length leaves old glyphs behind, so a label is
+      // always redrawn whole
+      clear_background();
+      pros::screen::set_pen(foreground);
+      pros::screen::set_eraser(background);
+      pros::screen::print(text_format, bounds.x0 + TEXT_PADDING,
+                          bounds.y0 + TEXT_PADDING, "%s", text);
+    }
+
+    Bar::Bar(Rect bounds, double minimum, double maximum)
+        : Widget(bounds), minimum(minimum), maximum(maximum), value(minimum) {}
+
+    void Bar::set_value(double value) {
+      this->value = value;
+      if(get_fill_width(value) != drawn_fill) {
+        mark_dirty();
+      }
+    }
+
+    double Bar::get_value() const { return value; }
+
+    void Bar::set_fill_color(uint32_t color) {
+      fill_color = color;
+      invalidate();
+    }
+
+    int16_t Bar::get_fill_width(double value) const {
+      // Inside the one pixel outline
+      const int16_t inner_width = bounds.get_width() - 2;
+      if(maximum <= minimum || value <= minimum) {
+        return 0;
+      }
+      if(value >= maximum) {
+        return inner_width;
+      }
+      return static_cast<int16_t>((value - minimum) / (maximum - minimum) *
+                                  inner_width);
+    }
+
+    void Bar::draw(bool is_full_redraw) {
+      const int16_t fill = get_fill_width(value);
+      const int16_t left = bounds.x0 + 1;
+      if(is_full_redraw) {
+        clear_background();
+        pros::screen::set_pen(foreground);
+        pros::screen::draw_rect(bounds.x0, bounds.y0, bounds.x1, bounds.y1);
+        drawn_fill = 0;
+      }
+      if(fill > drawn_fill) {
+        pros::screen::set_pen(fill_color);
+        pros::screen::fill_rect(left + drawn_fill, bounds.y0 + 1,
+                                left + fill - 1, bounds.y1 - 1);
+      } else if(fill < drawn_fill) {
+        clear_area(Rect{static_cast<int16_t>(left + fill),
+                        static_cast<int16_t>(bounds.y0 + 1),
+                        static_cast<int16_t>(left + drawn_fill - 1),
+                        static_cast<int16_t>(bounds.y1 - 1)});
+      }
+      drawn_fill = fill;
+    }
+
+    Slider::Slider(Rect bounds, double minimum, double maximum,
+                   SliderCallback callback, void* context)
+        : Bar(bounds, minimum, maximum), callback(callback), context(context) {}
+
+    void Slider::set_range(double minimum, double maximum) {
+      this->minimum = minimum;
+      this->maximum = maximum;
+      invalidate();
+    }
+
+    void Slider::set_callback(SliderCallback callback, void* context) {
+      this->callback = callback;
+      this->context = context;
+      is_pressed = false;
+    }
+
+    bool Slider::touch(int16_t x, int16_t y, pros::last_touch_e_t event) {
+      if(callback == nullptr) {
+        return false;
+      }
+      if(event == pros::E_TOUCH_PRESSED) {
+        if(!bounds.contains(x, y)) {
+          return false;
+        }
+        is_pressed = true;
+      } else if(event != pros::E_TOUCH_RELEASED || !is_pressed) {
+        return false;
+      } else {
+        is_pressed = false;
+      }
+      // Released outside the bar still counts, clamped to its ends
+      const double touched = get_touch_value(x);
+      set_value(touched);
+      callback(context, touched);
+      return true;
+    }
+
+    double Slider::get_touch_value(int16_t x) const {
+      const int16_t inner_width = bounds.get_width() - 2;
+      if(inner_width <= 0) {
+        return minimum;
+      }
+      const double fraction = static_cast<double>(x - bounds.x0 - 1) /
+                              inner_width;
+      if(fraction <= 0.0) {
+        return minimum;
+      }
+      if(fraction >= 1.0) {
+        return maximum;
+      }
+      return minimum + fraction * (maximum - minimum);
+    }
+
+    Button::Button(Rect bounds, const char* text, ButtonCallback callback,
+                   void* context)
+        : Widget(bounds), callback(callback), context(context) {
+      this->text[0] = '\0';
+      copy_text(this->text, text, sizeof(this->text));
+    }
+
+    void Button::set_text(const char* text) {
+      if(copy_text(this->text, text, sizeof(this->text))) {
+        mark_dirty();
+      }
+    }
+
+    void Button::set_callback(ButtonCallback callback, void* context) {
+      this->callback = callback;
+      this->context = context;
+    }
+
+    void Button::set_selected(bool selected) {
+      if(this->selected != selected) {
+        this->selected = selected;
+        mark_dirty();
+      }
+    }
+
+    bool Button::is_selected() const { return selected; }
+
+    bool Button::touch(int16_t x, int16_t y, pros::last_touch_e_t event) {
+      const bool is_inside = bounds.contains(x, y);
+      if(event == pros::E_TOUCH_PRESSED) {
+        if(is_inside) {
+          is_pressed = true;
+          mark_dirty();
+        }
+        return is_inside;
+      }
+      if(event != pros::E_TOUCH_RELEASED || !is_pressed) {
+        return false;
+      }
+      is_pressed = false;
+      mark_dirty();
+      if(is_inside && callback != nullptr) {
+        callback(context);
+      }
+      return true;
+    }
+
+    void Button::draw(bool) {
+      const bool is_filled = is_pressed || selected;
+      const uint32_t fill = is_filled ? foreground : background;
+      const uint32_t text_color = is_filled ? background : foreground;
+      pros::screen::set_pen(fill);
+      pros::screen::fill_rect(bounds.x0, bounds.y0, bounds.x1, bounds.y1);
+      pros::screen::set_pen(foreground);
+      pros::screen::draw_rect(bounds.x0, bounds.y0, bounds.x1, bounds.y1);
+      pros::screen::set_pen(text_color);
+      pros::screen::set_eraser(fill);
+      pros::screen::print(pros::E_TEXT_SMALL, bounds.x0 + TEXT_PADDING,
+                          bounds.y0 + TEXT_PADDING, "%s", text);
+    }
+
+    bool Page::add(Widget& widget) {
+      if(widget_count == MAX_WIDGETS) {
+        return false;
+      }
+      widgets[widget_count++] = &widget;
+      return true;
+    }
+
+    std::size_t Page::size() const { return widget_count; }
+
+    Widget& Page::get_widget(std::size_t index) const {
+      return *widgets[index];
+    }
+
+    void Page::invalidate() {
+      for(std::size_t i = 0; i < widget_count; i++) {
+        widgets[i]->invalidate();
+      }
+    }
+  }  // namespace gui
+}  // namespace apollo
@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/odometry/odometry.hpp"
+
+namespace apollo {
+  Odometry::Odometry() { reset(); }
+
+  void Odometry::reset(Pose new_pose) {
+    pose = new_pose;
+    has_baseline = false;
+  }
+
+  void Odometry::set_pose(Pose new_pose) { pose = new_pose; }
+
+  void Odometry::update(units::QLength left_distance,
+                        units::QLength right_distance, units::QAngle heading) {
+    const units::BinaryAngle current_heading(heading);
+    if(!has_baseline) {
+      last_left_distance = left_distance;
+      last_right_distance = right_distance;
+      last_heading = current_heading;
+      has_baseline = true;
+      return;
+    }
+    const units::QLength distance =
+        ((left_distance - last_left_distance) +
+         (right_distance - last_right_distance)) /
+        2;
+    const units::QAngle turned =
+        last_heading.shortest_difference(current_heading);
+
+    // Travel along the average heading of the step
+    const units::QAngle midpoint = pose.theta + turned / 2;
+    pose.x += distance * units::cos(midpoint).getValue();
+    pose.y += distance * units::sin(midpoint).getValue();
+    pose.theta += turned;
+
+    last_left_distance = left_distance;
+    last_right_distance = right_distance;
+    last_heading = current_heading;
+  }
+
+  Pose Odometry::get_pose() const { return pose; }
+}  // namespace apollo
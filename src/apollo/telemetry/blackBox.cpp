@@ -0,0 +1,176 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/telemetry/blackBox.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#include "pros/misc.hpp"
+
+namespace apollo {
+  namespace telemetry {
+    namespace {
+      std::atomic<BlackBox*> active_black_box{nullptr};
+      std::terminate_handler previous_terminate_handler = nullptr;
+    }  // namespace
+
+    BlackBox::BlackBox(const char* file_prefix, int32_t brownout_voltage,
+                       uint32_t checkpoint_interval)
+        : file_prefix(file_prefix),
+          brownout_voltage(brownout_voltage),
+          checkpoint_interval(checkpoint_interval) {}
+
+    BlackBox::~BlackBox() { stop(); }
+
+    bool BlackBox::start() {
+      if(running.load() || !pros::usd::is_installed()) {
+        return false;
+      }
+      char path[64];
+      std::snprintf(path, sizeof(path), "%s_event.bin", file_prefix);
+      event_file = std::fopen(path, "wb");
+      std::snprintf(path, sizeof(path), "%s_checkpoint.bin", file_prefix);
+      checkpoint_file = std::fopen(path, "wb");
+      if(event_file == nullptr || checkpoint_file == nullptr) {
+        if(event_file != nullptr) {
+          std::fclose(event_file);
+          event_file = nullptr;
+        }
+        if(checkpoint_file != nullptr) {
+          std::fclose(checkpoint_file);
+          checkpoint_file = nullptr;
+        }
+        return false;
+      }
+
+      running.store(true);
+      active_black_box.store(this);
+      previous_terminate_handler = std::set_terminate(terminate_handler);
+      monitor_task =
+          new pros::Task([this] { monitor_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo black box");
+      return true;
+    }
+
+    void BlackBox::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      monitor_task->join();
+      delete monitor_task;
+      monitor_task = nullptr;
+      BlackBox* self = this;
+      if(active_black_box.compare_exchange_strong(self, nullptr)) {
+        std::set_terminate(previous_terminate_handler);
+      }
+      // Wait out a dump another task may be writing
+      while(dumping.exchange(true)) {
+        pros::delay(1);
+      }
+      std::fclose(event_file);
+      std::fclose(checkpoint_file);
+      event_file = nullptr;
+      checkpoint_file = nullptr;
+      dumping.store(false);
+    }
+
+    bool BlackBox::trigger(black_box_reason reason, uint32_t timeout) {
+      if(!running.load()) {
+        return false;
+      }
+      return dump(event_file, reason, timeout);
+    }
+
+    void BlackBox::monitor_loop() {
+      bool is_browned_out = false;
+      uint32_t last_checkpoint = pros::millis();
+      while(running.load()) {
+        const int32_t voltage = pros::battery::get_voltage();
+        if(!is_browned_out && voltage > 0 && voltage < brownout_voltage) {
+          is_browned_out = dump(event_file, BLACK_BOX_BROWNOUT);
+        } else if(is_browned_out && voltage > brownout_voltage + 500) {
+          is_browned_out = false;
+        }
+        if(checkpoint_interval > 0 &&
+           pros::millis() - last_checkpoint >= checkpoint_interval) {
+          dump(checkpoint_file, BLACK_BOX_CHECKPOINT);
+          last_checkpoint = pros::millis();
+        }
+        pros::delay(20);
+      }
+    }
+
+    bool BlackBox::dump(std::FILE* file, black_box_reason reason,
+                        uint32_t timeout) {
+      const uint32_t wait_start = pros::millis();
+      while(dumping.exchange(true, std::memory_order_acquire)) {
+        if(pros::millis() - wait_start >= timeout) {
+          return false;
+        }
+        pros::delay(1);
+      }
+      const uint32_t end = next_index.load(std::memory_order_acquire);
+      const uint32_t begin = end > CAPACITY ? end - CAPACITY : 0;
+
+      std::fseek(file, 0, SEEK_SET);
+      LogFileHeader header;
+      std::memcpy(header.magic, LOG_FILE_MAGIC, sizeof(header.magic));
+      header.version = LOG_FILE_VERSION;
+      header.record_size = RECORD_SIZE;
+      std::fwrite(&header, sizeof(header), 1, file);
+      BlackBoxRecord marker;
+      marker.reason = reason;
+      marker.reserved = 0;
+      marker.battery_voltage = pros::battery::get_voltage();
+      marker.overwritten_count = begin;
+      const Record marker_record =
+          make_record(marker, static_cast<uint32_t>(pros::micros()));
+      std::fwrite(&marker_record, sizeof(Record), 1, file);
+
+      // Every dump has the same size, so a shorter dump never leaves records
+      // of an older one behind. Empty slots are written as zero-size records.
+      std::size_t staged = 0;
+      for(uint32_t i = 0; i < CAPACITY; i++) {
+        Record& record = staging[staged];
+        const uint32_t index = begin + i;
+        bool is_valid = false;
+        if(index < end) {
+          const Slot& slot = slots[index % CAPACITY];
+          const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+          record = slot.record;
+          std::atomic_thread_fence(std::memory_order_acquire);
+          const uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+          is_valid = before == after && before == 2 * index + 2;
+        }
+        if(!is_valid) {
+          std::memset(&record, 0, sizeof(record));
+        }
+        if(++staged == STAGING_RECORDS) {
+          std::fwrite(staging, sizeof(Record), staged, file);
+          staged = 0;
+        }
+      }
+      std::fwrite(staging, sizeof(Record), staged, file);
+      const bool is_written = std::fflush(file) == 0;
+      dumping.store(false, std::memory_order_release);
+      return is_written;
+    }
+
+    void BlackBox::terminate_handler() {
+      BlackBox* black_box = active_black_box.load();
+      if(black_box != nullptr) {
+        // A checkpoint may be in flight. The wait is bounded in case it is
+        // the checkpoint itself that called std::terminate.
+        black_box->trigger(BLACK_BOX_TERMINATE, TERMINATE_DUMP_TIMEOUT);
+      }
+      if(previous_terminate_handler != nullptr) {
+        previous_terminate_handler();
+      }
+      std::abort();
+    }
+  }  // namespace telemetry
+}  // namespace apollo
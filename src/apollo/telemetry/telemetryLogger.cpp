@@ -0,0 +1,134 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/telemetry/telemetryLogger.hpp"
+
+#include <cstring>
+
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace telemetry {
+    TelemetryLogger::TelemetryLogger(const char* file_prefix,
+                                     uint32_t flush_interval,
+                                     bool compressed, bool quantized)
+        : file_prefix(file_prefix),
+          flush_interval(flush_interval),
+          compressed(compressed),
+          encoder(0, quantized) {}
+
+    TelemetryLogger::~TelemetryLogger() { stop(); }
+
+    bool TelemetryLogger::start() {
+      if(running.load() || !pros::usd::is_installed()) {
+        return false;
+      }
+      char path[64];
+      for(int index = 0; index < 1000 && file == nullptr; index++) {
+        std::snprintf(path, sizeof(path), "%s_%03d.bin", file_prefix, index);
+        std::FILE* existing = std::fopen(path, "rb");
+        if(existing != nullptr) {
+          std::fclose(existing);
+          continue;
+        }
+        file = std::fopen(path, "wb");
+        if(file == nullptr) {
+          return false;
+        }
+      }
+      if(file == nullptr) {
+        return false;
+      }
+
+      LogFileHeader header;
+      std::memcpy(header.magic, LOG_FILE_MAGIC, sizeof(header.magic));
+      if(!compressed) {
+        header.version = LOG_FILE_VERSION;
+      } else if(encoder.is_quantized()) {
+        header.version = LOG_FILE_VERSION_DELTA_QUANTIZED;
+      } else {
+        header.version = LOG_FILE_VERSION_DELTA;
+      }
+      header.record_size = RECORD_SIZE;
+      std::fwrite(&header, sizeof(header), 1, file);
+
+      encoder.reset();
+      block_length = 0;
+      last_write_time = pros::millis();
+      running.store(true);
+      writer_task =
+          new pros::Task([this] { writer_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo telemetry");
+      return true;
+    }
+
+    void TelemetryLogger::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      writer_task->join();
+      delete writer_task;
+      writer_task = nullptr;
+    }
+
+    bool TelemetryLogger::is_running() const { return running.load(); }
+
+    uint32_t TelemetryLogger::get_dropped_count() const {
+      return dropped_count.load(std::memory_order_relaxed);
+    }
+
+    void TelemetryLogger::writer_loop() {
+      while(running.load()) {
+        drain();
+        if(block_length > 0 &&
+           pros::millis() - last_write_time >= flush_interval) {
+          write_block();
+        }
+        pros::delay(20);
+      }
+      drain();
+      write_block();
+      std::fclose(file);
+      file = nullptr;
+    }
+
+    void TelemetryLogger::drain() {
+      const uint32_t dropped = dropped_count.load(std::memory_order_relaxed);
+      if(dropped != reported_dropped_count) {
+        append(make_record(DroppedRecord{dropped - reported_dropped_count},
+                           static_cast<uint32_t>(pros::micros())));
+        reported_dropped_count = dropped;
+      }
+      Record record;
+      while(buffer.pop(record)) {
+        append(record);
+      }
+    }
+
+    void TelemetryLogger::append(const Record& record) {
+      const std::size_t largest_size =
+          compressed ? DELTA_MAX_ENCODED_SIZE : RECORD_SIZE;
+      if(block_length + largest_size > BLOCK_SIZE) {
+        write_block();
+      }
+      if(compressed) {
+        block_length += encoder.encode(record, block + block_length);
+      } else {
+        std::memcpy(block + block_length, &record, RECORD_SIZE);
+        block_length += RECORD_SIZE;
+      }
+    }
+
+    void TelemetryLogger::write_block() {
+      if(block_length > 0) {
+        std::fwrite(block, 1, block_length, file);
+        std::fflush(file);
+        block_length = 0;
+      }
+      last_write_time = pros::millis();
+    }
+  }  // namespace telemetry
+}  // namespace apollo
@@ -0,0 +1,151 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/telemetry/telemetryStream.hpp"
+
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "pros/apix.h"
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace telemetry {
+    TelemetryStream::TelemetryStream(uint32_t byte_budget, uint32_t period,
+                                     bool compressed)
+        : byte_budget(byte_budget), period(period), compressed(compressed) {
+      for(std::size_t i = 0; i < CHANNEL_COUNT; i++) {
+        decimation[i].store(1);
+        decimation_count[i].store(0);
+      }
+    }
+
+    TelemetryStream::~TelemetryStream() { stop(); }
+
+    bool TelemetryStream::start() {
+      if(running.load()) {
+        return false;
+      }
+      pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+      pros::c::fdctl(STDOUT_FILENO, SERCTL_NOBLKWRITE, nullptr);
+      encoder.reset();
+      running.store(true);
+      writer_task =
+          new pros::Task([this] { writer_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo stream");
+      return true;
+    }
+
+    void TelemetryStream::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      writer_task->join();
+      delete writer_task;
+      writer_task = nullptr;
+      pros::c::fdctl(STDOUT_FILENO, SERCTL_BLKWRITE, nullptr);
+      pros::c::serctl(SERCTL_ENABLE_COBS, nullptr);
+    }
+
+    bool TelemetryStream::is_running() const { return running.load(); }
+
+    void TelemetryStream::set_decimation(uint8_t channel, uint16_t every) {
+      if(channel < CHANNEL_COUNT) {
+        decimation[channel].store(every > 0 ? every : 1,
+                                  std::memory_order_relaxed);
+      }
+    }
+
+    uint32_t TelemetryStream::get_dropped_count() const {
+      return dropped_count.load(std::memory_order_relaxed);
+    }
+
+    bool TelemetryStream::is_selected(uint8_t channel) {
+      if(channel >= CHANNEL_COUNT) {
+        return true;
+      }
+      const uint16_t every =
+          decimation[channel].load(std::memory_order_relaxed);
+      return every <= 1 ||
+             decimation_count[channel].fetch_add(
+                 1, std::memory_order_relaxed) % every == 0;
+    }
+
+    void TelemetryStream::writer_loop() {
+      // Allow bursts of up to 100 ms worth of data
+      const uint32_t max_tokens = byte_budget / 10 > PACKET_FRAME_MAX_SIZE
+                                      ? byte_budget / 10
+                                      : PACKET_FRAME_MAX_SIZE;
+      uint32_t tokens = max_tokens;
+      uint32_t last_time = pros::millis();
+      Record record;
+      while(running.load()) {
+        const uint32_t now = pros::millis();
+        tokens += (byte_budget * (now - last_time)) / 1000;
+        if(tokens > max_tokens) {
+          tokens = max_tokens;
+        }
+        last_time = now;
+
+        // A leading delimiter separates frames from any printf output
+        output[0] = 0;
+        output_length = 1;
+        while(buffer.pop(record)) {
+          if(compressed) {
+            if(packet_length + DELTA_MAX_ENCODED_SIZE > PACKET_MAX_SIZE) {
+              send_packet(tokens);
+            }
+            packet_length += encoder.encode(record, packet + packet_length);
+            packet_records++;
+            continue;
+          }
+          if(output_length + FRAME_MAX_SIZE > OUTPUT_SIZE) {
+            flush();
+          }
+          const std::size_t size =
+              encode_frame(record, output + output_length);
+          if(size > tokens) {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+            continue;
+          }
+          tokens -= size;
+          output_length += size;
+        }
+        if(packet_length > 0) {
+          send_packet(tokens);
+        }
+        if(output_length > 1) {
+          flush();
+        }
+        pros::delay(period);
+      }
+    }
+
+    void TelemetryStream::send_packet(uint32_t& tokens) {
+      if(output_length + PACKET_FRAME_MAX_SIZE > OUTPUT_SIZE) {
+        flush();
+      }
+      const std::size_t size =
+          encode_packet_frame(packet, packet_length, output + output_length);
+      if(size > tokens) {
+        // Later deltas would refer to records the decoder never sees
+        dropped_count.fetch_add(packet_records, std::memory_order_relaxed);
+        encoder.reset();
+      } else {
+        tokens -= size;
+        output_length += size;
+      }
+      packet_length = 0;
+      packet_records = 0;
+    }
+
+    void TelemetryStream::flush() {
+      std::fwrite(output, 1, output_length, stdout);
+      std::fflush(stdout);
+      output_length = 0;
+    }
+  }  // namespace telemetry
+}  // namespace apollo
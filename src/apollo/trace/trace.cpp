@@ -0,0 +1,183 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/trace/trace.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include "pros/rtos.hpp"
+
+namespace apollo {
+  namespace trace {
+    namespace {
+      struct Event {
+        uint32_t timestamp;
+        const char* name;
+        uint8_t type;
+      };
+
+      /**
+       * @brief Events of one task. Only the owning task writes `events`, and
+       * `written` is published after each write.
+       *
+       */
+      struct TaskBuffer {
+        std::atomic<pros::task_t> owner{nullptr};
+        char name[TRACE_NAME_SIZE];
+        std::atomic<uint32_t> written{0};
+        Event events[EVENTS_PER_TASK];
+      };
+
+      TaskBuffer buffers[MAX_TASKS];
+      std::atomic<bool> recording{false};
+      std::atomic<uint32_t> dropped_count{0};
+
+      TaskBuffer* get_buffer() {
+        const pros::task_t task = pros::c::task_get_current();
+        for(TaskBuffer& buffer : buffers) {
+          pros::task_t owner = buffer.owner.load(std::memory_order_acquire);
+          if(owner == task) {
+            return &buffer;
+          }
+          if(owner == nullptr &&
+             buffer.owner.compare_exchange_strong(owner, task)) {
+            std::strncpy(buffer.name, pros::c::task_get_name(task),
+                         TRACE_NAME_SIZE - 1);
+            return &buffer;
+          }
+        }
+        return nullptr;
+      }
+
+      void record(const char* name, uint8_t type) {
+        if(!recording.load(std::memory_order_relaxed)) {
+          return;
+        }
+        TaskBuffer* buffer = get_buffer();
+        if(buffer == nullptr) {
+          dropped_count.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        const uint32_t written =
+            buffer->written.load(std::memory_order_relaxed);
+        Event& event = buffer->events[written % EVENTS_PER_TASK];
+        event.timestamp = static_cast<uint32_t>(pros::micros());
+        event.name = name;
+        event.type = type;
+        buffer->written.store(written + 1, std::memory_order_release);
+      }
+
+      uint16_t find_name(const char** names, uint16_t& name_count,
+                         const char* name) {
+        for(uint16_t i = 0; i < name_count; i++) {
+          if(names[i] == name) {
+            return i;
+          }
+        }
+        if(name_count == TRACE_MAX_NAMES) {
+          return TRACE_OVERFLOW_NAME;
+        }
+        names[name_count] = name;
+        return name_count++;
+      }
+    }  // namespace
+
+    void start() { recording.store(true); }
+
+    void stop() { recording.store(false); }
+
+    bool is_recording() { return recording.load(); }
+
+    void clear() {
+      for(TaskBuffer& buffer : buffers) {
+        buffer.written.store(0);
+      }
+      dropped_count.store(0);
+    }
+
+    void begin(const char* name) { record(name, TRACE_BEGIN); }
+
+    void end(const char* name) { record(name, TRACE_END); }
+
+    void instant(const char* name) { record(name, TRACE_INSTANT); }
+
+    uint32_t get_dropped_count() { return dropped_count.load(); }
+
+    bool dump(const char* path) {
+      std::FILE* file = std::fopen(path, "wb");
+      if(file == nullptr) {
+        return false;
+      }
+
+      // Collect the names first, so the file can list them before the events
+      static const char* names[TRACE_MAX_NAMES];
+      uint16_t name_count = 0;
+      uint16_t task_count = 0;
+      uint32_t event_count = 0;
+      uint16_t overflow_count = 0;
+      for(TaskBuffer& buffer : buffers) {
+        if(buffer.owner.load(std::memory_order_acquire) == nullptr) {
+          break;
+        }
+        task_count++;
+        const uint32_t written =
+            buffer.written.load(std::memory_order_acquire);
+        const uint32_t first =
+            written > EVENTS_PER_TASK ? written - EVENTS_PER_TASK : 0;
+        for(uint32_t i = first; i < written; i++) {
+          if(find_name(names, name_count,
+                       buffer.events[i % EVENTS_PER_TASK].name) ==
+                 TRACE_OVERFLOW_NAME &&
+             overflow_count < UINT16_MAX) {
+            overflow_count++;
+          }
+        }
+        event_count += written - first;
+      }
+
+      TraceFileHeader header;
+      std::memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+      header.version = TRACE_FILE_VERSION;
+      header.task_count = task_count;
+      header.name_count = name_count;
+      header.overflow_count = overflow_count;
+      header.dropped_count = dropped_count.load();
+      header.event_count = event_count;
+      std::fwrite(&header, sizeof(header), 1, file);
+
+      TraceFileName entry;
+      for(uint16_t i = 0; i < task_count; i++) {
+        std::memset(entry.name, 0, sizeof(entry.name));
+        std::strncpy(entry.name, buffers[i].name, TRACE_NAME_SIZE - 1);
+        std::fwrite(&entry, sizeof(entry), 1, file);
+      }
+      for(uint16_t i = 0; i < name_count; i++) {
+        std::memset(entry.name, 0, sizeof(entry.name));
+        std::strncpy(entry.name, names[i], TRACE_NAME_SIZE - 1);
+        std::fwrite(&entry, sizeof(entry), 1, file);
+      }
+
+      for(uint16_t task = 0; task < task_count; task++) {
+        TaskBuffer& buffer = buffers[task];
+        const uint32_t written =
+            buffer.written.load(std::memory_order_acquire);
+        const uint32_t first =
+            written > EVENTS_PER_TASK ? written - EVENTS_PER_TASK : 0;
+        for(uint32_t i = first; i < written; i++) {
+          const Event& event = buffer.events[i % EVENTS_PER_TASK];
+          TraceFileEvent output;
+          output.timestamp = event.timestamp;
+          output.name = find_name(names, name_count, event.name);
+          output.type = event.type;
+          output.task = static_cast<uint8_t>(task);
+          std::fwrite(&output, sizeof(output), 1, file);
+        }
+      }
+      return std::fclose(file) == 0;
+    }
+  }  // namespace trace
+}  // namespace apollo
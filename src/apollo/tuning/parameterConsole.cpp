@@ -0,0 +1,175 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/tuning/parameterConsole.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include "apollo/units/RQuantityFormat.hpp"
+#include "pros/llemu.h"
+#include "pros/llemu.hpp"
+
+namespace apollo {
+  ParameterConsole::ParameterConsole(ParameterRegistry& registry,
+                                     const char* path)
+      : registry(registry), path(path) {}
+
+  ParameterConsole::~ParameterConsole() {
+    // The serial task is blocked reading stdin and can't be joined
+    running.store(false);
+    if(serial_task != nullptr) {
+      serial_task->remove();
+      delete serial_task;
+    }
+    if(lcd_task != nullptr) {
+      lcd_task->join();
+      delete lcd_task;
+    }
+  }
+
+  bool ParameterConsole::start(bool serial, bool lcd) {
+    if(running.exchange(true)) {
+      return true;
+    }
+    // Without liblvgl the LLEMU functions are weak symbols that resolve to
+    // null, so calling them would jump to address 0
+    const bool is_lcd_ready = &pros::lcd::read_buttons != nullptr &&
+                              &pros::lcd::is_initialized != nullptr &&
+                              pros::lcd::is_initialized();
+    if(serial) {
+      serial_task =
+          new pros::Task([this] { serial_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo parameters");
+    }
+    if(lcd && is_lcd_ready) {
+      lcd_task = new pros::Task([this] { lcd_loop(); }, TASK_PRIORITY_MIN + 1,
+                                TASK_STACK_DEPTH_DEFAULT, "apollo lcd params");
+    }
+    return !lcd || is_lcd_ready;
+  }
+
+  bool ParameterConsole::run_command(char* line) {
+    char* command = std::strtok(line, " \t\r");
+    char* name = std::strtok(nullptr, " \t\r");
+    char* value = std::strtok(nullptr, " \t\r");
+    if(command == nullptr) {
+      return false;
+    }
+    if(std::strcmp(command, "list") == 0) {
+      for(std::size_t i = 0; i < registry.size(); i++) {
+        print_parameter(i);
+      }
+      return true;
+    }
+    if(std::strcmp(command, "save") == 0) {
+      const bool saved = registry.save(path);
+      std::printf(saved ? "saved %s\n" : "could not save %s\n", path);
+      return saved;
+    }
+    if(std::strcmp(command, "load") == 0) {
+      const bool loaded = registry.load(path);
+      std::printf(loaded ? "loaded %s\n" : "could not load %s\n", path);
+      if(loaded && registry.is_truncated()) {
+        std::printf("only the first %zu bytes were read\n",
+                    ParameterRegistry::MAX_FILE_SIZE);
+      }
+      return loaded;
+    }
+
+    const int index = name != nullptr ? registry.find(name) : -1;
+    if(index < 0) {
+      std::printf("unknown parameter %s\n", name != nullptr ? name : "");
+      return false;
+    }
+    if(std::strcmp(command, "get") == 0) {
+      print_parameter(index);
+      return true;
+    }
+    if(std::strcmp(command, "reset") == 0) {
+      registry.reset_value(index);
+      print_parameter(index);
+      return true;
+    }
+    if(std::strcmp(command, "set") == 0 && value != nullptr) {
+      double number;
+      if(units::parse(value, number) == 0) {
+        std::printf("not a number: %s\n", value);
+        return false;
+      }
+      registry.set_value(index, number);
+      print_parameter(index);
+      return true;
+    }
+    std::printf("usage: list | get NAME | set NAME VALUE | reset NAME | "
+                "save | load\n");
+    return false;
+  }
+
+  void ParameterConsole::serial_loop() {
+    char line[96];
+    std::size_t length = 0;
+    int c;
+    while(running.load() && (c = std::getchar()) != EOF) {
+      if(c != '\n') {
+        if(length < sizeof(line) - 1) {
+          line[length++] = static_cast<char>(c);
+        }
+        continue;
+      }
+      line[length] = '\0';
+      run_command(line);
+      length = 0;
+    }
+  }
+
+  void ParameterConsole::lcd_loop() {
+    uint8_t previous_buttons = 0;
+    bool changed = false;
+    draw_lcd();
+    while(running.load()) {
+      const uint8_t buttons = pros::lcd::read_buttons();
+      const uint8_t pressed = buttons & ~previous_buttons;
+      previous_buttons = buttons;
+      if(pressed != 0 && registry.size() > 0) {
+        if(pressed & LCD_BTN_LEFT) {
+          changed |= registry.step_value(selected, -1);
+        }
+        if(pressed & LCD_BTN_RIGHT) {
+          changed |= registry.step_value(selected, 1);
+        }
+        if(pressed & LCD_BTN_CENTER) {
+          if(changed) {
+            registry.save(path);
+            changed = false;
+          }
+          selected = (selected + 1) % registry.size();
+        }
+        draw_lcd();
+      }
+      pros::delay(50);
+    }
+  }
+
+  void ParameterConsole::draw_lcd() {
+    if(registry.size() == 0) {
+      pros::lcd::print(0, "No parameters");
+      return;
+    }
+    char value[32];
+    registry.format_value(selected, value, sizeof(value));
+    pros::lcd::print(0, "Parameter %u/%u", static_cast<unsigned>(selected + 1),
+                     static_cast<unsigned>(registry.size()));
+    pros::lcd::print(1, "%s", registry.get_entry(selected).name);
+    pros::lcd::print(2, "%s", value);
+    pros::lcd::print(3, "[-]      [next]      [+]");
+  }
+
+  void ParameterConsole::print_parameter(std::size_t index) {
+    char value[32];
+    registry.format_value(index, value, sizeof(value));
+    std::printf("%s = %s\n", registry.get_entry(index).name, value);
+  }
+}  // namespace apollo
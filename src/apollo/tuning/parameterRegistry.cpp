@@ -0,0 +1,208 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/tuning/parameterRegistry.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "apollo/units/RQuantityFormat.hpp"
+
+namespace apollo {
+  Parameter<double> ParameterRegistry::add(const char* name,
+                                           double default_value,
+                                           double minimum, double maximum,
+                                           double step) {
+    ParameterEntry* entry = add_entry(name, PARAMETER_DOUBLE, default_value,
+                                      minimum, maximum, step, 1.0, nullptr);
+    return {entry != nullptr ? &entry->value : nullptr, default_value};
+  }
+
+  Parameter<int> ParameterRegistry::add(const char* name, int default_value,
+                                        int minimum, int maximum, int step) {
+    ParameterEntry* entry = add_entry(name, PARAMETER_INT, default_value,
+                                      minimum, maximum, step, 1.0, nullptr);
+    return {entry != nullptr ? &entry->value : nullptr, default_value};
+  }
+
+  Parameter<bool> ParameterRegistry::add(const char* name,
+                                         bool default_value) {
+    ParameterEntry* entry =
+        add_entry(name, PARAMETER_BOOL, default_value ? 1.0 : 0.0, 0.0, 1.0,
+                  1.0, 1.0, nullptr);
+    return {entry != nullptr ? &entry->value : nullptr, default_value};
+  }
+
+  ParameterEntry* ParameterRegistry::add_entry(const char* name,
+                                               parameter_type type,
+                                               double default_value,
+                                               double minimum, double maximum,
+                                               double step, double unit,
+                                               const char* suffix) {
+    if(count == MAX_PARAMETERS || name == nullptr || find(name) >= 0 ||
+       !(minimum <= maximum)) {
+      return nullptr;
+    }
+    ParameterEntry& entry = entries[count];
+    entry.name = name;
+    entry.type = type;
+    entry.minimum = minimum;
+    entry.maximum = maximum;
+    entry.step = step > 0.0 ? step : (maximum - minimum) / unit / 100.0;
+    entry.unit = unit;
+    entry.suffix = suffix;
+    entry.default_value = default_value;
+    entry.value.store(default_value);
+    count++;
+    return &entry;
+  }
+
+  std::size_t ParameterRegistry::size() const { return count; }
+
+  const ParameterEntry& ParameterRegistry::get_entry(std::size_t index) const {
+    return entries[index];
+  }
+
+  int ParameterRegistry::find(const char* name) const {
+    for(std::size_t i = 0; i < count; i++) {
+      if(std::strcmp(entries[i].name, name) == 0) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  double ParameterRegistry::get_value(std::size_t index) const {
+    if(index >= count) {
+      return 0.0;
+    }
+    return entries[index].value.load(std::memory_order_relaxed) /
+           entries[index].unit;
+  }
+
+  bool ParameterRegistry::set_value(std::size_t index, double value) {
+    if(index >= count || std::isnan(value)) {
+      return false;
+    }
+    ParameterEntry& entry = entries[index];
+    value *= entry.unit;
+    if(entry.type != PARAMETER_DOUBLE) {
+      value = std::round(value);
+    }
+    if(value < entry.minimum) {
+      value = entry.minimum;
+    } else if(value > entry.maximum) {
+      value = entry.maximum;
+    }
+    entry.value.store(value, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool ParameterRegistry::step_value(std::size_t index, int steps) {
+    if(index >= count) {
+      return false;
+    }
+    if(entries[index].type == PARAMETER_BOOL) {
+      return set_value(index, steps % 2 != 0 ? 1.0 - get_value(index)
+                                             : get_value(index));
+    }
+    return set_value(index, get_value(index) + steps * entries[index].step);
+  }
+
+  bool ParameterRegistry::reset_value(std::size_t index) {
+    if(index >= count) {
+      return false;
+    }
+    entries[index].value.store(entries[index].default_value,
+                               std::memory_order_relaxed);
+    return true;
+  }
+
+  int ParameterRegistry::format_value(std::size_t index, char* buffer,
+                                      std::size_t size) const {
+    if(index >= count) {
+      return std::snprintf(buffer, size, "%s", "");
+    }
+    const ParameterEntry& entry = entries[index];
+    const double value = get_value(index);
+    if(entry.type == PARAMETER_BOOL) {
+      return std::snprintf(buffer, size, "%s", value != 0.0 ? "on" : "off");
+    }
+    int length = units::format(buffer, size, value,
+                               entry.type == PARAMETER_INT ? 0 : 3);
+    if(entry.suffix != nullptr && static_cast<std::size_t>(length) + 1 < size) {
+      length += std::snprintf(buffer + length, size - length, " %s",
+                              entry.suffix);
+    }
+    return length;
+  }
+
+  bool ParameterRegistry::save(const char* path) const {
+    std::FILE* file = std::fopen(path, "w");
+    if(file == nullptr) {
+      return false;
+    }
+    char value[32];
+    for(std::size_t i = 0; i < count; i++) {
+      units::format(value, sizeof(value), get_value(i),
+                    entries[i].type == PARAMETER_DOUBLE ? 6 : 0);
+      std::fprintf(file, "%s %s\n", entries[i].name, value);
+    }
+    return std::fclose(file) == 0;
+  }
+
+  bool ParameterRegistry::load(const char* path) {
+    std::FILE* file = std::fopen(path, "r");
+    if(file == nullptr) {
+      return false;
+    }
+    char text[MAX_FILE_SIZE];
+    std::size_t length = std::fread(text, 1, sizeof(text), file);
+    truncated = length == sizeof(text) && std::fgetc(file) != EOF;
+    std::fclose(file);
+    if(truncated) {
+      // The last line was cut off, and applying "kP 0.12" from
+      // "kP 0.125" would be worse than skipping it
+      while(length > 0 && text[length - 1] != '\n') {
+        length--;
+      }
+    }
+    parse(text, length);
+    return true;
+  }
+
+  bool ParameterRegistry::is_truncated() const { return truncated; }
+
+  int ParameterRegistry::parse(const char* text, std::size_t length) {
+    int applied = 0;
+    std::size_t line_start = 0;
+    while(line_start < length) {
+      std::size_t line_end = line_start;
+      while(line_end < length && text[line_end] != '\n') {
+        line_end++;
+      }
+      char line[96];
+      const std::size_t line_length = line_end - line_start;
+      if(line_length > 0 && line_length < sizeof(line) &&
+         text[line_start] != '#') {
+        std::memcpy(line, text + line_start, line_length);
+        line[line_length] = '\0';
+        char* separator = std::strchr(line, ' ');
+        if(separator != nullptr) {
+          *separator = '\0';
+          double value;
+          const int index = find(line);
+          if(units::parse(separator + 1, value) > 0 && index >= 0 &&
+             set_value(static_cast<std::size_t>(index), value)) {
+            applied++;
+          }
+        }
+      }
+      line_start = line_end + 1;
+    }
+    return applied;
+  }
+}  // namespace apollo
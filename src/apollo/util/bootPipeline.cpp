@@ -0,0 +1,168 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/util/bootPipeline.hpp"
+
+#include <cerrno>
+
+#include "pros/error.h"
+#include "pros/imu.h"
+
+apollo::util::BootPipeline boot_pipeline;
+
+namespace apollo {
+  namespace util {
+    namespace {
+      /**
+       * @brief How often IMU status and readiness are polled
+       *
+       */
+      constexpr uint32_t POLL_PERIOD = 5;
+    }  // namespace
+
+    BootPipeline::BootPipeline(uint32_t calibration_timeout)
+        : calibration_timeout(calibration_timeout) {}
+
+    BootPipeline::~BootPipeline() {
+      if(boot_task != nullptr) {
+        boot_task->join();
+        delete boot_task;
+      }
+    }
+
+    bool BootPipeline::add_imu(uint8_t port) {
+      if(imu_count == MAX_IMUS) {
+        return false;
+      }
+      imu_ports[imu_count++] = port;
+      return true;
+    }
+
+    bool BootPipeline::add_step(const char* name, BootStep step,
+                                void* context) {
+      if(step_count == MAX_STEPS) {
+        return false;
+      }
+      steps[step_count++] = Step{name, step, context, false, 0};
+      return true;
+    }
+
+    void BootPipeline::start() {
+      if(started.exchange(true)) {
+        return;
+      }
+      start_time = pros::millis();
+      // Default priority, since autonomous() may be waiting on it
+      boot_task = new pros::Task([this] { boot(); }, TASK_PRIORITY_DEFAULT,
+                                 TASK_STACK_DEPTH_DEFAULT, "apollo boot");
+    }
+
+    bool BootPipeline::is_ready() const {
+      return ready.load(std::memory_order_acquire);
+    }
+
+    bool BootPipeline::wait_until_ready(uint32_t timeout) {
+      const uint32_t start = pros::millis();
+      while(!is_ready()) {
+        if(!started.load() || pros::millis() - start >= timeout) {
+          return false;
+        }
+        pros::delay(POLL_PERIOD);
+      }
+      return true;
+    }
+
+    bool BootPipeline::is_imu_calibrated() const { return imu_calibrated; }
+
+    bool BootPipeline::is_loaded() const { return loaded; }
+
+    std::size_t BootPipeline::get_step_count() const { return step_count; }
+
+    const char* BootPipeline::get_step_name(std::size_t index) const {
+      return steps[index].name;
+    }
+
+    bool BootPipeline::get_step_result(std::size_t index) const {
+      return steps[index].result;
+    }
+
+    uint32_t BootPipeline::get_step_time(std::size_t index) const {
+      return steps[index].time;
+    }
+
+    uint32_t BootPipeline::get_boot_time() const {
+      return is_ready() ? boot_time : 0;
+    }
+
+    void BootPipeline::reset_imus() {
+      // imu_reset() returns once the calibrating flag is set, so
+      // wait_for_calibration() can take a clear flag as done. EAGAIN means
+      // either that it was already calibrating, which is just as good, or
+      // that the flag never got set, so the status tells the two apart.
+      for(std::size_t i = 0; i < imu_count; i++) {
+        if(pros::c::imu_reset(imu_ports[i]) != PROS_ERR) {
+          is_imu_reset[i] = true;
+        } else if(errno == EAGAIN) {
+          const pros::imu_status_e_t status =
+              pros::c::imu_get_status(imu_ports[i]);
+          // The error status has every bit set, calibrating included
+          is_imu_reset[i] = status != pros::E_IMU_STATUS_ERROR &&
+                            (status & pros::E_IMU_STATUS_CALIBRATING);
+        }
+      }
+    }
+
+    void BootPipeline::boot() {
+      // imu_reset() can block for up to a second per IMU, so it is called
+      // here rather than in start(). Calibration then runs on the IMUs
+      // themselves while the steps load.
+      reset_imus();
+      bool is_every_step_loaded = true;
+      for(std::size_t i = 0; i < step_count; i++) {
+        Step& step = steps[i];
+        const uint32_t step_start = pros::millis();
+        step.result = step.function(step.context);
+        step.time = pros::millis() - step_start;
+        is_every_step_loaded = is_every_step_loaded && step.result;
+      }
+      loaded = is_every_step_loaded;
+      imu_calibrated = wait_for_calibration();
+      boot_time = pros::millis() - start_time;
+      ready.store(true, std::memory_order_release);
+    }
+
+    bool BootPipeline::wait_for_calibration() {
+      // IMUs are polled together, so one that finished while the steps ran
+      // is done on the first pass
+      bool is_done[MAX_IMUS] = {};
+      bool is_calibrated = true;
+      std::size_t done_count = 0;
+      while(done_count < imu_count) {
+        for(std::size_t i = 0; i < imu_count; i++) {
+          if(is_done[i]) {
+            continue;
+          }
+          const pros::imu_status_e_t status =
+              pros::c::imu_get_status(imu_ports[i]);
+          if(!is_imu_reset[i] || status == pros::E_IMU_STATUS_ERROR) {
+            is_calibrated = false;
+            is_done[i] = true;
+          } else if(!(status & pros::E_IMU_STATUS_CALIBRATING)) {
+            is_done[i] = true;
+          }
+          done_count += is_done[i] ? 1 : 0;
+        }
+        if(done_count == imu_count) {
+          break;
+        }
+        if(pros::millis() - start_time >= calibration_timeout) {
+          return false;
+        }
+        pros::delay(POLL_PERIOD);
+      }
+      return is_calibrated;
+    }
+  }  // namespace util
+}  // namespace apollo
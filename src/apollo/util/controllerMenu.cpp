@@ -0,0 +1,312 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/util/controllerMenu.hpp"
+
+#include <cstring>
+
+namespace apollo {
+  namespace util {
+    namespace {
+      enum menu_button : uint32_t {
+        BUTTON_UP = 1 << 0,
+        BUTTON_DOWN = 1 << 1,
+        BUTTON_LEFT = 1 << 2,
+        BUTTON_RIGHT = 1 << 3,
+        BUTTON_A = 1 << 4,
+        BUTTON_B = 1 << 5
+      };
+
+      /**
+       * @brief true while a competition switch or field controller has the
+       * robot enabled
+       *
+       */
+      bool is_match_running() {
+        const uint8_t status = pros::competition::get_status();
+        return (status & COMPETITION_CONNECTED) &&
+               !(status & COMPETITION_DISABLED);
+      }
+    }  // namespace
+
+    bool MenuPage::add_action(const char* name, MenuCallback action,
+                              void* context) {
+      return add(Item{MENU_ACTION, name, context, action, nullptr, nullptr,
+                      nullptr, 0});
+    }
+
+    bool MenuPage::add_toggle(const char* name, std::atomic<bool>& value) {
+      return add(Item{MENU_TOGGLE, name, &value, nullptr, nullptr, nullptr,
+                      nullptr, 0});
+    }
+
+    bool MenuPage::add_choice(const char* name, const char* const* options,
+                              std::size_t option_count,
+                              std::atomic<int>& selected) {
+      if(option_count == 0) {
+        return false;
+      }
+      return add(Item{MENU_CHOICE, name, &selected, nullptr, nullptr, nullptr,
+                      options, option_count});
+    }
+
+    bool MenuPage::add_value(const char* name, MenuText text, void* context) {
+      return add_item(name, text, nullptr, context);
+    }
+
+    bool MenuPage::add_item(const char* name, MenuText text, MenuAdjust adjust,
+                            void* context) {
+      return add(
+          Item{MENU_ITEM, name, context, nullptr, text, adjust, nullptr, 0});
+    }
+
+    bool MenuPage::add_submenu(const char* name, MenuPage& page) {
+      return add(Item{MENU_SUBMENU, name, &page, nullptr, nullptr, nullptr,
+                      nullptr, 0});
+    }
+
+    bool MenuPage::add(const Item& item) {
+      if(item_count == MAX_ITEMS) {
+        return false;
+      }
+      items[item_count++] = item;
+      return true;
+    }
+
+    ControllerMenu::ControllerMenu(pros::Controller& controller,
+                                   ControllerOutput& output, uint32_t period)
+        : controller(controller), output(output), period(period) {}
+
+    ControllerMenu::~ControllerMenu() { stop(); }
+
+    void ControllerMenu::set_root(MenuPage& page) {
+      levels[0] = Level{&page, 0, 0};
+      depth = 1;
+    }
+
+    void ControllerMenu::start() {
+      if(running.exchange(true)) {
+        return;
+      }
+      menu_task =
+          new pros::Task([this] { menu_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo controller menu");
+    }
+
+    void ControllerMenu::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      menu_task->join();
+      delete menu_task;
+      menu_task = nullptr;
+    }
+
+    void ControllerMenu::set_enabled(bool is_enabled) {
+      enabled.store(is_enabled);
+    }
+
+    bool ControllerMenu::is_enabled() const { return enabled.load(); }
+
+    void ControllerMenu::menu_loop() {
+      uint32_t wake_time = pros::millis();
+      while(running.load()) {
+        update();
+        pros::Task::delay_until(&wake_time, period);
+      }
+    }
+
+    void ControllerMenu::update() {
+      // Buttons are tracked while disabled too, so one held down while the
+      // menu is enabled doesn't count as a press
+      const uint32_t presses = read_presses();
+      if(depth == 0 || !enabled.load() || is_match_running()) {
+        return;
+      }
+
+      if(presses & BUTTON_UP) {
+        move_cursor(-1);
+      }
+      if(presses & BUTTON_DOWN) {
+        move_cursor(1);
+      }
+      if(presses & BUTTON_LEFT) {
+        adjust(-1);
+      }
+      if(presses & (BUTTON_RIGHT | BUTTON_A)) {
+        select();
+      }
+      if(presses & BUTTON_B) {
+        back();
+      }
+      render();
+    }
+
+    uint32_t ControllerMenu::read_presses() {
+      uint32_t buttons = 0;
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_UP)) {
+        buttons |= BUTTON_UP;
+      }
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN)) {
+        buttons |= BUTTON_DOWN;
+      }
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_LEFT)) {
+        buttons |= BUTTON_LEFT;
+      }
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
+        buttons |= BUTTON_RIGHT;
+      }
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_A)) {
+        buttons |= BUTTON_A;
+      }
+      if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_B)) {
+        buttons |= BUTTON_B;
+      }
+      const uint32_t presses = buttons & ~held_buttons;
+      held_buttons = buttons;
+      return presses;
+    }
+
+    void ControllerMenu::move_cursor(int direction) {
+      Level& level = levels[depth - 1];
+      const std::size_t count = level.page->item_count;
+      if(count == 0) {
+        return;
+      }
+      level.cursor = (level.cursor + count + direction) % count;
+      // Keep the cursor on screen
+      if(level.cursor < level.scroll) {
+        level.scroll = level.cursor;
+      } else if(level.cursor >= level.scroll + CONTROLLER_LINE_COUNT) {
+        level.scroll = level.cursor - CONTROLLER_LINE_COUNT + 1;
+      }
+    }
+
+    void ControllerMenu::adjust(int direction) {
+      const Level& level = levels[depth - 1];
+      if(level.cursor >= level.page->item_count) {
+        return;
+      }
+      const MenuPage::Item& item = level.page->items[level.cursor];
+      switch(item.type) {
+        case MenuPage::MENU_TOGGLE: {
+          std::atomic<bool>& value =
+              *static_cast<std::atomic<bool>*>(item.context);
+          value.store(!value.load());
+          break;
+        }
+        case MenuPage::MENU_CHOICE: {
+          std::atomic<int>& selected =
+              *static_cast<std::atomic<int>*>(item.context);
+          const int count = static_cast<int>(item.option_count);
+          selected.store(((selected.load() + direction) % count + count) %
+                         count);
+          break;
+        }
+        case MenuPage::MENU_ITEM:
+          if(item.adjust != nullptr) {
+            item.adjust(item.context, direction);
+          }
+          break;
+        case MenuPage::MENU_ACTION:
+        case MenuPage::MENU_SUBMENU:
+          break;
+      }
+    }
+
+    void ControllerMenu::select() {
+      const Level& level = levels[depth - 1];
+      if(level.cursor >= level.page->item_count) {
+        return;
+      }
+      const MenuPage::Item& item = level.page->items[level.cursor];
+      if(item.type == MenuPage::MENU_ACTION) {
+        if(item.action != nullptr) {
+          item.action(item.context);
+        }
+      } else if(item.type == MenuPage::MENU_SUBMENU) {
+        if(depth < MAX_DEPTH) {
+          levels[depth++] = Level{static_cast<MenuPage*>(item.context), 0, 0};
+        }
+      } else {
+        adjust(1);
+      }
+    }
+
+    void ControllerMenu::back() {
+      if(depth > 1) {
+        depth--;
+      }
+    }
+
+    void ControllerMenu::render() {
+      const Level& level = levels[depth - 1];
+      for(std::size_t line = 0; line < CONTROLLER_LINE_COUNT; line++) {
+        char text[CONTROLLER_LINE_WIDTH + 1];
+        const std::size_t index = level.scroll + line;
+        if(index < level.page->item_count) {
+          render_item(level.page->items[index], index == level.cursor, text);
+        } else {
+          std::memset(text, ' ', CONTROLLER_LINE_WIDTH);
+          text[CONTROLLER_LINE_WIDTH] = '\0';
+        }
+        // Every line is queued every period, since something else, like
+        // MotorHealthMonitor's warning, may have written over it. The
+        // output compares against what the controller shows and sends
+        // nothing for a line that is already right.
+        output.set_text(line, text);
+      }
+    }
+
+    void ControllerMenu::render_item(const MenuPage::Item& item,
+                                     bool is_selected, char* line) const {
+      char value[CONTROLLER_LINE_WIDTH + 1] = "";
+      switch(item.type) {
+        case MenuPage::MENU_TOGGLE:
+          std::strcpy(value,
+                      static_cast<std::atomic<bool>*>(item.context)->load()
+                          ? "on"
+                          : "off");
+          break;
+        case MenuPage::MENU_CHOICE: {
+          const int selected =
+              static_cast<std::atomic<int>*>(item.context)->load();
+          if(selected >= 0 && selected < static_cast<int>(item.option_count)) {
+            std::strncpy(value, item.options[selected], sizeof(value) - 1);
+            value[sizeof(value) - 1] = '\0';
+          }
+          break;
+        }
+        case MenuPage::MENU_ITEM:
+          if(item.text != nullptr) {
+            item.text(item.context, value, sizeof(value));
+          }
+          break;
+        case MenuPage::MENU_SUBMENU:
+          std::strcpy(value, ">");
+          break;
+        case MenuPage::MENU_ACTION:
+          break;
+      }
+
+      // Cursor, name, and the value right aligned. The value wins when
+      // both don't fit, keeping at least one character of the name.
+      std::memset(line, ' ', CONTROLLER_LINE_WIDTH);
+      line[CONTROLLER_LINE_WIDTH] = '\0';
+      line[0] = is_selected ? '>' : ' ';
+      std::size_t value_length = std::strlen(value);
+      if(value_length > CONTROLLER_LINE_WIDTH - 3) {
+        value_length = CONTROLLER_LINE_WIDTH - 3;
+      }
+      const std::size_t name_width =
+          CONTROLLER_LINE_WIDTH - 1 - (value_length > 0 ? value_length + 1 : 0);
+      for(std::size_t i = 0; i < name_width && item.name[i] != '\0'; i++) {
+        line[1 + i] = item.name[i];
+      }
+      std::memcpy(line + CONTROLLER_LINE_WIDTH - value_length, value,
+                  value_length);
+    }
+  }  // namespace util
+}  // namespace apollo
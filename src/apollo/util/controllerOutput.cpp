@@ -0,0 +1,173 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "apollo/util/controllerOutput.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "apollo/util/util.hpp"
+
+apollo::util::ControllerOutput master_output(master);
+
+namespace apollo {
+  namespace util {
+    ControllerOutput::ControllerOutput(pros::Controller& controller,
+                                       uint32_t period)
+        : controller(controller), period(period) {
+      for(std::size_t line = 0; line < CONTROLLER_LINE_COUNT; line++) {
+        std::memset(desired[line], ' ', CONTROLLER_LINE_WIDTH);
+        desired[line][CONTROLLER_LINE_WIDTH] = '\0';
+        // Nothing is known about the screen, so every line is sent once
+        shown[line][0] = '\0';
+      }
+    }
+
+    ControllerOutput::~ControllerOutput() { stop(); }
+
+    void ControllerOutput::start() {
+      if(running.exchange(true)) {
+        return;
+      }
+      output_task =
+          new pros::Task([this] { output_loop(); }, TASK_PRIORITY_MIN + 1,
+                         TASK_STACK_DEPTH_DEFAULT, "apollo controller");
+    }
+
+    void ControllerOutput::stop() {
+      if(!running.exchange(false)) {
+        return;
+      }
+      output_task->join();
+      delete output_task;
+      output_task = nullptr;
+    }
+
+    bool ControllerOutput::print(uint8_t line, const char* format, ...) {
+      char text[CONTROLLER_LINE_WIDTH + 1];
+      va_list arguments;
+      va_start(arguments, format);
+      std::vsnprintf(text, sizeof(text), format, arguments);
+      va_end(arguments);
+      return push(COMMAND_TEXT, line, text);
+    }
+
+    bool ControllerOutput::set_text(uint8_t line, const char* text) {
+      return push(COMMAND_TEXT, line, text);
+    }
+
+    bool ControllerOutput::clear_line(uint8_t line) {
+      return push(COMMAND_TEXT, line, "");
+    }
+
+    bool ControllerOutput::clear() {
+      bool queued = true;
+      for(uint8_t line = 0; line < CONTROLLER_LINE_COUNT; line++) {
+        queued &= clear_line(line);
+      }
+      return queued;
+    }
+
+    bool ControllerOutput::rumble(const char* pattern) {
+      return push(COMMAND_RUMBLE, 0, pattern);
+    }
+
+    bool ControllerOutput::push(command_type type, uint8_t line,
+                                const char* text) {
+      if(line >= CONTROLLER_LINE_COUNT) {
+        return false;
+      }
+      Command command;
+      command.type = type;
+      command.line = line;
+      const std::size_t width = type == COMMAND_TEXT ? CONTROLLER_LINE_WIDTH
+                                                     : CONTROLLER_RUMBLE_LENGTH;
+      std::size_t length = 0;
+      while(length < width && text[length] != '\0') {
+        command.text[length] = text[length];
+        length++;
+      }
+      if(type == COMMAND_TEXT) {
+        // Padding overwrites whatever a longer previous text left behind
+        std::memset(command.text + length, ' ', width - length);
+        length = width;
+      }
+      command.text[length] = '\0';
+      return queue.push(command);
+    }
+
+    void ControllerOutput::output_loop() {
+      uint32_t wake_time = pros::millis();
+      while(running.load()) {
+        drain();
+        if(!controller.is_connected()) {
+          // Whatever the screen showed is lost once it reconnects
+          for(std::size_t line = 0; line < CONTROLLER_LINE_COUNT; line++) {
+            shown[line][0] = '\0';
+          }
+        } else {
+          send_next();
+        }
+        pros::Task::delay_until(&wake_time, period);
+      }
+    }
+
+    void ControllerOutput::drain() {
+      Command command;
+      while(queue.pop(command)) {
+        if(command.type == COMMAND_TEXT) {
+          std::memcpy(desired[command.line], command.text,
+                      sizeof(command.text));
+        } else if(rumble_count < RUMBLE_CAPACITY) {
+          std::memcpy(rumbles[rumble_count++], command.text,
+                      CONTROLLER_RUMBLE_LENGTH + 1);
+        }
+      }
+    }
+
+    bool ControllerOutput::send_next() {
+      if(rumble_count > 0) {
+        if(controller.rumble(rumbles[0]) != 1) {
+          return false;
+        }
+        rumble_count--;
+        std::memmove(rumbles[0], rumbles[1],
+                     rumble_count * sizeof(rumbles[0]));
+        return true;
+      }
+      // Round robin, so one busy line can't starve the others
+      for(std::size_t i = 0; i < CONTROLLER_LINE_COUNT; i++) {
+        const std::size_t line = (next_line + i) % CONTROLLER_LINE_COUNT;
+        if(std::strcmp(desired[line], shown[line]) == 0) {
+          continue;
+        }
+        next_line = (line + 1) % CONTROLLER_LINE_COUNT;
+        // Only the span from the first to the last changed character is
+        // sent. A line of unknown contents is sent whole.
+        std::size_t first = 0;
+        std::size_t last = CONTROLLER_LINE_WIDTH - 1;
+        if(shown[line][0] != '\0') {
+          while(desired[line][first] == shown[line][first]) {
+            first++;
+          }
+          while(desired[line][last] == shown[line][last]) {
+            last--;
+          }
+        }
+        char text[CONTROLLER_LINE_WIDTH + 1];
+        const std::size_t length = last - first + 1;
+        std::memcpy(text, desired[line] + first, length);
+        text[length] = '\0';
+        if(controller.set_text(line, first, text) != 1) {
+          return false;
+        }
+        std::memcpy(shown[line], desired[line], sizeof(desired[line]));
+        return true;
+      }
+      return false;
+    }
+  }  // namespace util
+}  // namespace apollo
@@ -10,23 +10,6 @@
 pros::Controller master(pros::E_CONTROLLER_MASTER);
 namespace apollo {
 namespace util {
-int convert_gear_ratio(pros::v5::MotorGears input) {
-  if (input == pros::v5::MotorGears::ratio_18_to_1 ||
-      input == pros::v5::MotorGears::green ||
-      input == pros::v5::MotorGears::rpm_200) {
-    return 200;
-  } else if (input == pros::v5::MotorGears::ratio_36_to_1 ||
-             input == pros::v5::MotorGears::blue ||
-             input == pros::v5::MotorGears::rpm_600) {
-    return 600;
-  } else if (input == pros::v5::MotorGears::ratio_6_to_1 ||
-             input == pros::v5::MotorGears::red ||
-             input == pros::v5::MotorGears::rpm_100) {
-    return 100;
-  } else {
-    return INT32_MAX;
-  }
-}
 bool is_reversed(double input) {
   if (input < 0) {
     return true;
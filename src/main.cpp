@@ -1,8 +1,24 @@
 #include "main.h"
-void initialize() { pros::lcd::initialize(); }
+
+// Checked when building, so a wheel in millimeters or a gear ratio written
+// upside down fails the build instead of the autonomous
+constexpr DrivetrainConfig drive_config{
+    .motor_cartridge = pros::v5::MotorGears::blue,
+    .gear_ratio = 48.0 / 36.0,
+    .wheel_diameter = 3.25 * units::inch,
+    .track_width = 11.5 * units::inch,
+    .motors_per_side = 3,
+    .robot_mass = 6 * units::kg};
+static_assert(drive_config.is_valid(), "check drive_config in main.cpp");
+
+void initialize() {
+  boot_pipeline.start();
+  master_output.start();
+  brain_gui.start();
+}
 void disabled() {}
 void competition_initialize() {}
-void autonomous() {}
+void autonomous() { boot_pipeline.wait_until_ready(); }
 void opcontrol() {
   while (true) {
     pros::delay(20);
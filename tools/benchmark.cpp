@@ -0,0 +1,480 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/**
+ * Native benchmarks of apollo's hot paths. Every case runs a fixed number of
+ * samples of a fixed number of iterations, with fixed inputs, so runs on the
+ * same machine are comparable across commits.
+ *
+ *   benchmark [--csv] [--samples N] [--filter TEXT] [--label TEXT]
+ *
+ * Prints JSON by default, or CSV with --csv. Timings are nanoseconds per
+ * iteration.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "apollo/control/pidController.hpp"
+// pros/screen.h, which the GUI headers include, defines _GNU_SOURCE again
+#undef _GNU_SOURCE
+#include "apollo/gui/gui.hpp"
+#include "apollo/linalg/decomposition.hpp"
+#include "apollo/linalg/matrix.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/telemetry/deltaCodec.hpp"
+#include "apollo/telemetry/ringBuffer.hpp"
+#include "apollo/telemetry/streamFrame.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+#include "apollo/tuning/parameterRegistry.hpp"
+#include "apollo/units/QAngle.hpp"
+#include "apollo/units/QBinaryAngle.hpp"
+#include "apollo/units/QLength.hpp"
+#include "apollo/units/QSpeed.hpp"
+#include "apollo/units/QTime.hpp"
+#include "apollo/units/RQuantityFormat.hpp"
+#include "apollo/util/util.hpp"
+
+using namespace apollo;
+
+/**
+ * Keeps the compiler from optimizing away a result it can see is unused
+ */
+template <typename T>
+inline void keep(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Result {
+  const char* name;
+  int iterations;
+  int samples;
+  double min;
+  double median;
+  double p99;
+  double p999;
+  double max;
+  double mean;
+};
+
+struct Options {
+  bool csv = false;
+  int samples = 200;
+  const char* filter = nullptr;
+  const char* label = "";
+};
+
+static std::vector<Result> results;
+static Options options;
+
+/**
+ * Times `samples` runs of `iterations` calls to `body`, after one warm-up run
+ */
+template <typename Body>
+static void run(const char* name, int iterations, Body&& body) {
+  if(options.filter != nullptr &&
+     std::strstr(name, options.filter) == nullptr) {
+    return;
+  }
+  using clock = std::chrono::steady_clock;
+  for(int i = 0; i < iterations; i++) {
+    body(i);
+  }
+  std::vector<double> timings(options.samples);
+  for(double& timing : timings) {
+    const clock::time_point start = clock::now();
+    for(int i = 0; i < iterations; i++) {
+      body(i);
+    }
+    const clock::time_point end = clock::now();
+    timing = std::chrono::duration<double, std::nano>(end - start).count() /
+             iterations;
+  }
+  std::sort(timings.begin(), timings.end());
+  double total = 0.0;
+  for(double timing : timings) {
+    total += timing;
+  }
+  const std::size_t count = timings.size();
+  results.push_back({name, iterations, options.samples, timings.front(),
+                     timings[count / 2], timings[(count * 99) / 100],
+                     timings[(count * 999) / 1000], timings.back(),
+                     total / count});
+}
+
+/**
+ * Times `calls` calls to `body` one at a time, after as many warm-up calls,
+ * for cases where the slowest call matters more than the average. Each
+ * timing has the cost of reading the clock, measured the same way, taken
+ * off. Reported with 1 iteration and `calls` samples.
+ */
+template <typename Body>
+static void run_calls(const char* name, int calls, Body&& body) {
+  if(options.filter != nullptr &&
+     std::strstr(name, options.filter) == nullptr) {
+    return;
+  }
+  using clock = std::chrono::steady_clock;
+  std::vector<double> overheads(calls);
+  for(double& overhead : overheads) {
+    const clock::time_point start = clock::now();
+    const clock::time_point end = clock::now();
+    overhead = std::chrono::duration<double, std::nano>(end - start).count();
+  }
+  std::sort(overheads.begin(), overheads.end());
+  const double overhead = overheads[overheads.size() / 2];
+  for(int i = 0; i < calls; i++) {
+    body(i);
+  }
+  std::vector<double> timings(calls);
+  for(int i = 0; i < calls; i++) {
+    const clock::time_point start = clock::now();
+    body(i);
+    const clock::time_point end = clock::now();
+    timings[i] = std::max(
+        0.0,
+        std::chrono::duration<double, std::nano>(end - start).count() -
+            overhead);
+  }
+  std::sort(timings.begin(), timings.end());
+  double total = 0.0;
+  for(double timing : timings) {
+    total += timing;
+  }
+  const std::size_t count = timings.size();
+  results.push_back({name, 1, calls, timings.front(), timings[count / 2],
+                     timings[(count * 99) / 100],
+                     timings[(count * 999) / 1000], timings.back(),
+                     total / count});
+}
+
+static void benchmark_driver_control() {
+  // The curve is a setting read at run time in opcontrol, so it is kept
+  // opaque here too rather than folded into the call
+  static double curve = 0.5;
+  keep(curve);
+  run("driver_control.drive_voltage", 10000, [](int i) {
+    keep(util::drive_voltage(i % 255 - 127, 5, curve));
+  });
+}
+
+static void benchmark_snapshots() {
+  static telemetry::RingBuffer<telemetry::Record, 1024> buffer;
+  run("snapshot.chassis_record", 10000, [](int i) {
+    const float position = static_cast<float>(i);
+    keep(telemetry::make_record(
+        telemetry::ChassisRecord{position, position, 200.0f, 200.0f, 6000,
+                                 6000, 90.0f},
+        static_cast<uint32_t>(i)));
+  });
+  run("snapshot.ring_buffer_push_pop", 10000, [](int i) {
+    telemetry::Record record;
+    record.header.timestamp = static_cast<uint32_t>(i);
+    buffer.push(record);
+    buffer.pop(record);
+    keep(record);
+  });
+}
+
+static void benchmark_units() {
+  run("units.length_arithmetic", 10000, [](int i) {
+    const units::QLength distance = (i % 100) * units::inch;
+    const units::QSpeed speed = distance / (0.01 * units::second);
+    keep(speed.convert(units::mps) + distance.convert(units::meter));
+  });
+  run("units.binary_angle_difference", 10000, [](int i) {
+    const units::BinaryAngle a((i % 720) * units::degree);
+    const units::BinaryAngle b((i % 360 - 180) * units::degree);
+    keep(a.shortest_difference(b));
+  });
+  run("units.format_quantity", 1000, [](int i) {
+    char buffer[32];
+    keep(units::format(buffer, sizeof(buffer), (i % 100) * units::inch,
+                       units::inch, "in", 2));
+  });
+}
+
+static void benchmark_odometry() {
+  static Odometry odometry;
+  run("odometry.update", 10000, [](int i) {
+    odometry.update(i * 0.001 * units::meter, i * 0.0011 * units::meter,
+                    (i % 3600) * 0.1 * units::degree);
+    keep(odometry.get_pose());
+  });
+}
+
+static void benchmark_controllers() {
+  static PIDController controller(0.5, 0.01, 0.1, 100.0);
+  run("control.pid_step", 10000, [](int i) {
+    keep(controller.step((i % 200) - 100.0, 0.01 * units::second));
+  });
+  static ParameterRegistry registry;
+  static Parameter<double> gain = registry.add("bench.kP", 0.5, 0.0, 5.0);
+  for(const char* name : {"bench.a", "bench.b", "bench.c", "bench.d"}) {
+    registry.add(name, 0.0, 0.0, 1.0);
+  }
+  run("control.parameter_read", 10000, [](int) { keep(gain.get()); });
+  run("control.parameter_find", 10000,
+      [](int) { keep(registry.find("bench.d")); });
+}
+
+static void benchmark_linalg() {
+  linalg::Matrix<double, 4, 4> a;
+  linalg::Matrix<double, 4, 4> b;
+  for(std::size_t row = 0; row < 4; row++) {
+    for(std::size_t column = 0; column < 4; column++) {
+      a(row, column) = 1.0 + row * 4 + column;
+      b(row, column) = (row == column ? 2.0 : 0.5);
+    }
+  }
+  run("linalg.multiply_4x4", 10000, [&](int) {
+    keep(a * b);
+    keep(a);
+  });
+  run("linalg.multiply_4x4_naive_loop", 10000, [&](int) {
+    double result[4][4];
+    for(std::size_t row = 0; row < 4; row++) {
+      for(std::size_t column = 0; column < 4; column++) {
+        double sum = 0.0;
+        for(std::size_t k = 0; k < 4; k++) {
+          sum += a(row, k) * b(k, column);
+        }
+        result[row][column] = sum;
+      }
+    }
+    keep(result);
+    keep(a);
+  });
+  // Not const, so keep() makes every iteration reload them instead of
+  // letting the compiler solve the system once at compile time
+  linalg::Matrix<double, 3, 3> system(4.0, 1.0, 2.0, 1.0, 5.0, 1.0, 2.0, 1.0,
+                                      6.0);
+  linalg::Vector<double, 3> rhs(1.0, 2.0, 3.0);
+  run("linalg.solve_3x3", 10000, [&](int) {
+    linalg::Vector<double, 3> x;
+    keep(linalg::solve(system, rhs, x));
+    keep(x);
+    keep(system);
+  });
+  // The same partial pivoting LU with runtime loops, as it was written
+  // before the decompositions were unrolled
+  run("linalg.solve_3x3_naive_loop", 10000, [&](int) {
+    double lu[3][3];
+    double x[3];
+    std::size_t permutation[3] = {0, 1, 2};
+    for(std::size_t row = 0; row < 3; row++) {
+      for(std::size_t column = 0; column < 3; column++) {
+        lu[row][column] = system(row, column);
+      }
+    }
+    for(std::size_t k = 0; k < 3; k++) {
+      std::size_t pivot = k;
+      for(std::size_t i = k + 1; i < 3; i++) {
+        if(std::fabs(lu[i][k]) > std::fabs(lu[pivot][k])) {
+          pivot = i;
+        }
+      }
+      if(pivot != k) {
+        for(std::size_t j = 0; j < 3; j++) {
+          std::swap(lu[k][j], lu[pivot][j]);
+        }
+        std::swap(permutation[k], permutation[pivot]);
+      }
+      for(std::size_t i = k + 1; i < 3; i++) {
+        lu[i][k] /= lu[k][k];
+        for(std::size_t j = k + 1; j < 3; j++) {
+          lu[i][j] -= lu[i][k] * lu[k][j];
+        }
+      }
+    }
+    for(std::size_t i = 0; i < 3; i++) {
+      double sum = rhs(permutation[i], 0);
+      for(std::size_t j = 0; j < i; j++) {
+        sum -= lu[i][j] * x[j];
+      }
+      x[i] = sum;
+    }
+    for(std::size_t i = 3; i-- > 0;) {
+      double sum = x[i];
+      for(std::size_t j = i + 1; j < 3; j++) {
+        sum -= lu[i][j] * x[j];
+      }
+      x[i] = sum / lu[i][i];
+    }
+    keep(x);
+    keep(system);
+  });
+  run("linalg.cholesky_solve_3x3", 10000, [&](int) {
+    const linalg::CholeskyDecomposition<3> cholesky(system);
+    keep(cholesky.solve(rhs));
+    keep(system);
+  });
+}
+
+static void benchmark_telemetry() {
+  static telemetry::DeltaEncoder encoder;
+  run("telemetry.delta_encode_chassis", 10000, [](int i) {
+    const float position = static_cast<float>(i);
+    const telemetry::Record record = telemetry::make_record(
+        telemetry::ChassisRecord{position, position * 0.97f, 200.0f, 194.0f,
+                                 6000, 5800, i * 0.05f},
+        static_cast<uint32_t>(i) * 10000u);
+    uint8_t output[telemetry::DELTA_MAX_ENCODED_SIZE];
+    keep(encoder.encode(record, output));
+  });
+  run("telemetry.encode_frame", 10000, [](int i) {
+    const telemetry::Record record = telemetry::make_record(
+        telemetry::PoseRecord{i * 0.01f, i * 0.02f, 1.0f},
+        static_cast<uint32_t>(i));
+    uint8_t output[telemetry::FRAME_MAX_SIZE];
+    keep(telemetry::encode_frame(record, output));
+  });
+}
+
+/**
+ * GUI::post_* needs PROS to link, so these cases repeat what a post costs
+ * the calling task: filling a message, formatting for post_print, and
+ * pushing onto the queue. GUI::Message is private, so GuiMessage copies its
+ * layout, taking the sizes from the GUI headers. The pop stands in for the
+ * GUI task draining the queue.
+ */
+struct GuiMessage {
+  uint8_t type;
+  uint8_t count;
+  void* target;
+  void (*function)(void* context);
+  union {
+    char text[gui::Label::TEXT_SIZE];
+    double values[gui::Plot::MAX_SERIES];
+  };
+};
+
+static telemetry::RingBuffer<GuiMessage, GUI::QUEUE_CAPACITY> gui_queue;
+
+static bool post_print(const char* format, ...) {
+  GuiMessage message;
+  message.type = 0;
+  message.target = &gui_queue;
+  va_list arguments;
+  va_start(arguments, format);
+  std::vsnprintf(message.text, sizeof(message.text), format, arguments);
+  va_end(arguments);
+  return gui_queue.push(message);
+}
+
+static bool post_text(const char* text) {
+  GuiMessage message;
+  message.type = 0;
+  message.target = &gui_queue;
+  std::strncpy(message.text, text, sizeof(message.text) - 1);
+  message.text[sizeof(message.text) - 1] = '\0';
+  return gui_queue.push(message);
+}
+
+static bool post_value(double value) {
+  GuiMessage message;
+  message.type = 1;
+  message.target = &gui_queue;
+  message.values[0] = value;
+  return gui_queue.push(message);
+}
+
+static void benchmark_gui() {
+  GuiMessage drained;
+  run("gui.post_text", 10000, [&](int) {
+    keep(post_text("Auton: left side"));
+    gui_queue.pop(drained);
+    keep(drained);
+  });
+  run("gui.post_print", 10000, [&](int i) {
+    keep(post_print("Battery %d%%  %.2f V  %s", i % 100, 12.0 + i * 0.001,
+                    "ok"));
+    gui_queue.pop(drained);
+    keep(drained);
+  });
+  run("gui.post_value", 10000, [&](int i) {
+    keep(post_value(i * 0.5));
+    gui_queue.pop(drained);
+    keep(drained);
+  });
+  // A control loop posts once per tick, so the slowest single post is what
+  // it feels. Each timing includes the pop, like the cases above.
+  run_calls("gui.post_text_single", 100000, [&](int) {
+    keep(post_text("Auton: left side"));
+    gui_queue.pop(drained);
+  });
+  run_calls("gui.post_value_single", 100000, [&](int i) {
+    keep(post_value(i * 0.5));
+    gui_queue.pop(drained);
+  });
+}
+
+static void print_json() {
+  std::printf("{\n  \"label\": \"%s\",\n  \"compiler\": \"%s\",\n"
+              "  \"unit\": \"ns\",\n  \"benchmarks\": [\n",
+              options.label, __VERSION__);
+  for(std::size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    std::printf("    {\"name\": \"%s\", \"iterations\": %d, \"samples\": %d, "
+                "\"min\": %.2f, \"median\": %.2f, \"p99\": %.2f, "
+                "\"p99.9\": %.2f, \"max\": %.2f, \"mean\": %.2f}%s\n",
+                result.name, result.iterations, result.samples, result.min,
+                result.median, result.p99, result.p999, result.max,
+                result.mean,
+                i + 1 < results.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+static void print_csv() {
+  std::printf("label,name,iterations,samples,min_ns,median_ns,p99_ns,"
+              "p999_ns,max_ns,mean_ns\n");
+  for(const Result& result : results) {
+    std::printf("%s,%s,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", options.label,
+                result.name, result.iterations, result.samples, result.min,
+                result.median, result.p99, result.p999, result.max,
+                result.mean);
+  }
+}
+
+int main(int argc, char** argv) {
+  for(int i = 1; i < argc; i++) {
+    if(std::strcmp(argv[i], "--csv") == 0) {
+      options.csv = true;
+    } else if(std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+      options.samples = std::max(1, std::atoi(argv[++i]));
+    } else if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if(std::strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+      options.label = argv[++i];
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--csv] [--samples N] [--filter TEXT] "
+                   "[--label TEXT]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+  benchmark_driver_control();
+  benchmark_snapshots();
+  benchmark_units();
+  benchmark_odometry();
+  benchmark_controllers();
+  benchmark_linalg();
+  benchmark_telemetry();
+  benchmark_gui();
+  if(options.csv) {
+    print_csv();
+  } else {
+    print_json();
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstdio>
+
+#include "apollo/telemetry/telemetryRecord.hpp"
+
+/**
+ * CSV output shared by the native telemetry tools. Every line starts with
+ * the timestamp and channel name, followed by that channel's fields.
+ */
+inline void print_csv_header(std::FILE* output) {
+  std::fprintf(output, "timestamp_us,channel,values...\n");
+}
+
+inline void print_record(std::FILE* output,
+                         const apollo::telemetry::Record& record) {
+  using namespace apollo::telemetry;
+  if(record.header.channel == CHANNEL_DROPPED && record.header.size == 0) {
+    // Empty slot of a black box dump
+    return;
+  }
+  const unsigned long timestamp = record.header.timestamp;
+  DroppedRecord dropped;
+  ChassisRecord chassis;
+  TrackerRecord tracker;
+  PoseRecord pose;
+  ControllerRecord controller;
+  CustomRecord custom;
+  BlackBoxRecord black_box;
+  DriveTargetRecord drive_target;
+  if(read_record(record, dropped)) {
+    std::fprintf(output, "%lu,dropped,%u\n", timestamp,
+                 static_cast<unsigned>(dropped.count));
+  } else if(read_record(record, chassis)) {
+    std::fprintf(output, "%lu,chassis,%g,%g,%g,%g,%d,%d,%g\n", timestamp,
+                 chassis.left_position, chassis.right_position,
+                 chassis.left_velocity, chassis.right_velocity,
+                 chassis.left_voltage, chassis.right_voltage, chassis.heading);
+  } else if(read_record(record, tracker)) {
+    std::fprintf(output, "%lu,tracker,%g,%g,%g\n", timestamp,
+                 tracker.left_position, tracker.right_position,
+                 tracker.center_position);
+  } else if(read_record(record, pose)) {
+    std::fprintf(output, "%lu,pose,%g,%g,%g\n", timestamp, pose.x, pose.y,
+                 pose.theta);
+  } else if(read_record(record, controller)) {
+    std::fprintf(output, "%lu,controller,%d,%d,%d,%d,%u\n", timestamp,
+                 controller.left_x, controller.left_y, controller.right_x,
+                 controller.right_y, static_cast<unsigned>(controller.buttons));
+  } else if(read_record(record, custom)) {
+    std::fprintf(output, "%lu,custom,%u,%g,%g,%g,%g,%g\n", timestamp,
+                 static_cast<unsigned>(custom.id), custom.values[0],
+                 custom.values[1], custom.values[2], custom.values[3],
+                 custom.values[4]);
+  } else if(read_record(record, black_box)) {
+    static const char* const REASONS[] = {"checkpoint", "brownout",
+                                          "terminate", "manual"};
+    std::fprintf(output, "%lu,black_box,%s,%ld,%lu\n", timestamp,
+                 black_box.reason < 4 ? REASONS[black_box.reason] : "unknown",
+                 static_cast<long>(black_box.battery_voltage),
+                 static_cast<unsigned long>(black_box.overwritten_count));
+  } else if(read_record(record, drive_target)) {
+    std::fprintf(output, "%lu,drive_target,%g,%u,%u\n", timestamp,
+                 drive_target.distance,
+                 static_cast<unsigned>(drive_target.period),
+                 static_cast<unsigned>(drive_target.is_active));
+  } else {
+    std::fprintf(output, "%lu,unknown,%u\n", timestamp,
+                 static_cast<unsigned>(record.header.channel));
+  }
+}
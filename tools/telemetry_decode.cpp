@@ -0,0 +1,178 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/**
+ * Native decoder for apollo telemetry. Prints one CSV line per record.
+ *
+ *   telemetry_decode --log apollo_000.bin
+ *   telemetry_decode --stream capture.bin
+ *   cat /dev/ttyACM1 | telemetry_decode --stream -
+ *   telemetry_decode --raw-stream capture.bin
+ */
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "apollo/telemetry/deltaCodec.hpp"
+#include "apollo/telemetry/replay.hpp"
+#include "apollo/telemetry/streamFrame.hpp"
+#include "apollo/telemetry/telemetryRecord.hpp"
+#include "telemetryPrint.hpp"
+
+using namespace apollo::telemetry;
+
+static int decode_log(const char* path) {
+  std::vector<Record> records;
+  if(!read_log_file(path, records)) {
+    std::fprintf(stderr, "%s: not a supported apollo telemetry log\n", path);
+    return 1;
+  }
+  for(const Record& record : records) {
+    print_record(stdout, record);
+  }
+  return 0;
+}
+
+/**
+ * A byte of printf output from the robot, which is printable ASCII
+ */
+static bool is_text(uint8_t byte) {
+  return (byte >= 0x20 && byte <= 0x7E) || byte == '\n' || byte == '\r' ||
+         byte == '\t';
+}
+
+struct StreamDecoder {
+  bool compressed;
+  // TelemetryStream always quantizes
+  DeltaDecoder decoder{true};
+  unsigned long bad_frames = 0;
+  unsigned long skipped_records = 0;
+
+  /**
+   * @brief Prints the records of one frame
+   *
+   * @return false if `data` is not a valid frame
+   */
+  bool decode(const uint8_t* data, std::size_t length) {
+    Record record;
+    if(!compressed) {
+      if(!decode_frame(data, length, record)) {
+        return false;
+      }
+      print_record(stdout, record);
+      return true;
+    }
+    uint8_t packet[PACKET_FRAME_MAX_SIZE];
+    std::size_t packet_length;
+    if(!decode_packet_frame(data, length, packet, packet_length)) {
+      return false;
+    }
+    std::size_t index = 0;
+    std::size_t consumed;
+    while(index < packet_length) {
+      const decode_result result = decoder.decode(
+          packet + index, packet_length - index, record, consumed);
+      if(result == DECODE_MALFORMED) {
+        // The CRC passed, so the packet itself is bad and the channel
+        // states can't be trusted
+        bad_frames++;
+        decoder.reset();
+        break;
+      }
+      if(result == DECODE_OK) {
+        print_record(stdout, record);
+      } else {
+        skipped_records++;
+      }
+      index += consumed;
+    }
+    return true;
+  }
+};
+
+static int decode_stream(std::FILE* input, bool compressed) {
+  // Anything longer than a frame is printf output, which is passed through
+  const std::size_t max_frame_size =
+      compressed ? PACKET_FRAME_MAX_SIZE : FRAME_MAX_SIZE;
+  uint8_t pending[4096];
+  std::size_t pending_length = 0;
+  StreamDecoder stream{compressed};
+  int c;
+  while((c = std::fgetc(input)) != EOF) {
+    if(c != 0) {
+      if(pending_length < sizeof(pending)) {
+        pending[pending_length++] = static_cast<uint8_t>(c);
+      }
+      continue;
+    }
+    if(pending_length == 0) {
+      continue;
+    }
+    if(stream.decode(pending, pending_length)) {
+      pending_length = 0;
+      continue;
+    }
+    // printf output between frames ends up in front of the next frame, so
+    // a segment may be lines of text, or lines of text followed by a frame.
+    // Frame bytes can look like text too, so every line end is tried.
+    std::size_t text_length = 0;
+    for(std::size_t i = 0; i < pending_length && is_text(pending[i]); i++) {
+      if(pending[i] == '\n' &&
+         (i + 1 == pending_length ||
+          stream.decode(pending + i + 1, pending_length - i - 1))) {
+        text_length = i + 1;
+        break;
+      }
+    }
+    if(text_length > 0) {
+      std::fwrite(pending, 1, text_length, stderr);
+    } else if(pending_length > max_frame_size) {
+      std::fwrite(pending, 1, pending_length, stderr);
+    } else {
+      // Lost bytes may have taken a keyframe with them
+      stream.bad_frames++;
+      stream.decoder.reset();
+    }
+    pending_length = 0;
+  }
+  if(stream.bad_frames > 0) {
+    std::fprintf(stderr, "%lu corrupt frames skipped\n", stream.bad_frames);
+  }
+  if(stream.skipped_records > 0) {
+    std::fprintf(stderr, "%lu records skipped waiting for a keyframe\n",
+                 stream.skipped_records);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if(argc != 3 || (std::strcmp(argv[1], "--log") != 0 &&
+                   std::strcmp(argv[1], "--stream") != 0 &&
+                   std::strcmp(argv[1], "--raw-stream") != 0)) {
+    std::fprintf(stderr,
+                 "usage: %s --log FILE | --stream FILE|- | "
+                 "--raw-stream FILE|-\n",
+                 argv[0]);
+    return 2;
+  }
+  if(std::strcmp(argv[1], "--log") == 0) {
+    print_csv_header(stdout);
+    return decode_log(argv[2]);
+  }
+  std::FILE* input = std::strcmp(argv[2], "-") == 0
+                         ? stdin
+                         : std::fopen(argv[2], "rb");
+  if(input == nullptr) {
+    std::perror(argv[2]);
+    return 1;
+  }
+  print_csv_header(stdout);
+  const int result =
+      decode_stream(input, std::strcmp(argv[1], "--stream") == 0);
+  if(input != stdin) {
+    std::fclose(input);
+  }
+  return result;
+}
@@ -0,0 +1,317 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/**
+ * Replays the chassis and tracking wheel samples of one or more telemetry
+ * logs through apollo::Odometry and reports how far the replayed pose
+ * drifts from the pose the robot logged. Without --tracker the sensored
+ * motors are integrated, as on a TankModel without tracking wheels.
+ *
+ *   telemetry_replay --cartridge blue --ratio 1.333 --wheel 3.25 log.bin...
+ *   telemetry_replay --tracker rotation --tracker-wheel 2 log.bin...
+ *
+ * At a gap left by dropped records, the pose is seeded again from the next
+ * logged pose and any drive move in progress stops being compared.
+ *
+ * With --drive, the TankModel::drive_distance() moves in the log are also
+ * run through apollo::DriveController, and its commands are diffed against
+ * the voltages the robot sent. Pass the gains to evaluate; the defaults are
+ * TankModel's. The exit status is 1 if any command differs from the log by
+ * more than the tolerance, in millivolts.
+ *
+ *   telemetry_replay --drive --distance-pid 600,0,40 --heading-pid 300,0,20
+ *       --tolerance 0 log.bin...
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "apollo/chassis/drivetrainGeometry.hpp"
+#include "apollo/control/driveController.hpp"
+#include "apollo/odometry/odometry.hpp"
+#include "apollo/telemetry/replay.hpp"
+#include "apollo/util/util.hpp"
+
+using namespace apollo;
+using namespace apollo::telemetry;
+
+class OdometryReplay : public ReplayTarget {
+ public:
+  /**
+   * @param tracker_geometry Geometry of the tracking wheels, or nullptr to
+   * integrate the sensored motors as a TankModel without trackers does
+   */
+  OdometryReplay(const DrivetrainGeometry& geometry,
+                 const DrivetrainGeometry* tracker_geometry)
+      : geometry(geometry),
+        tracker_geometry(tracker_geometry != nullptr ? *tracker_geometry
+                                                     : geometry),
+        is_tracked(tracker_geometry != nullptr) {}
+
+  void on_record(const Record& record) override {
+    // Samples on either side of a gap are not consecutive, so the replayed
+    // pose is wrong until it is seeded again from the next logged pose
+    DroppedRecord dropped;
+    if(read_record(record, dropped)) {
+      has_start_pose = false;
+      return;
+    }
+    // TankModel logs the tracker record right after the chassis record of
+    // the same tick, so it is integrated with that tick's heading
+    TrackerRecord tracker;
+    if(is_tracked && has_heading && read_record(record, tracker)) {
+      odometry.update(tracker_geometry.ticks_to_length(tracker.left_position),
+                      tracker_geometry.ticks_to_length(tracker.right_position),
+                      heading);
+      return;
+    }
+    // Start from wherever the robot believed it was. The sensor baseline
+    // is the tick just replayed, which is what this pose was logged after.
+    PoseRecord pose;
+    if(!has_start_pose && read_record(record, pose)) {
+      odometry.set_pose({pose.x * units::meter, pose.y * units::meter,
+                         pose.theta * units::radian});
+      has_start_pose = true;
+      is_seeding = true;
+    }
+  }
+
+  bool step(uint32_t /*timestamp*/, const ChassisRecord& chassis,
+            ReplayCommand& /*command*/) override {
+    heading = -chassis.heading * units::degree;
+    has_heading = true;
+    if(!is_tracked) {
+      odometry.update(geometry.ticks_to_length(chassis.left_position),
+                      geometry.ticks_to_length(chassis.right_position),
+                      heading);
+    }
+    return false;
+  }
+
+  bool get_pose(PoseRecord& pose) override {
+    // The pose that seeded the replay would trivially match itself
+    if(!has_start_pose || is_seeding) {
+      is_seeding = false;
+      return false;
+    }
+    const Pose current = odometry.get_pose();
+    pose.x = static_cast<float>(current.x.convert(units::meter));
+    pose.y = static_cast<float>(current.y.convert(units::meter));
+    pose.theta = static_cast<float>(current.theta.convert(units::radian));
+    return true;
+  }
+
+ private:
+  DrivetrainGeometry geometry;
+  DrivetrainGeometry tracker_geometry;
+  bool is_tracked;
+  Odometry odometry;
+  units::QAngle heading = units::QAngle(0.0);
+  bool has_heading = false;
+  bool has_start_pose = false;
+  bool is_seeding = false;
+};
+
+class DriveReplay : public ReplayTarget {
+ public:
+  DriveReplay(const DrivetrainGeometry& geometry,
+              const DriveController& controller)
+      : geometry(geometry), controller(controller) {}
+
+  void on_record(const Record& record) override {
+    // The controller's integral and derivative can't be rebuilt across a
+    // gap, so the rest of the move is not compared
+    DroppedRecord dropped;
+    if(read_record(record, dropped)) {
+      is_active = false;
+      return;
+    }
+    DriveTargetRecord target;
+    if(read_record(record, target)) {
+      is_active = target.is_active != 0;
+      is_starting = is_active;
+      distance = target.distance * units::inch;
+      period = target.period * units::millisecond;
+    }
+  }
+
+  bool step(uint32_t /*timestamp*/, const ChassisRecord& chassis,
+            ReplayCommand& command) override {
+    if(!is_active) {
+      return false;
+    }
+    // The same conversions TankModel::drive_distance() makes
+    const units::QLength left = geometry.ticks_to_length(chassis.left_position);
+    const units::QLength right =
+        geometry.ticks_to_length(chassis.right_position);
+    const units::QAngle heading = chassis.heading * units::degree;
+    if(is_starting) {
+      controller.start(distance, left, right, heading);
+      is_starting = false;
+    }
+    const DriveOutput output = controller.step(left, right, heading, period);
+    command.left_voltage = static_cast<int16_t>(output.left_voltage);
+    command.right_voltage = static_cast<int16_t>(output.right_voltage);
+    return true;
+  }
+
+ private:
+  DrivetrainGeometry geometry;
+  DriveController controller;
+  bool is_active = false;
+  bool is_starting = false;
+  units::QLength distance = units::QLength(0.0);
+  units::QTime period = units::QTime(0.0);
+};
+
+static bool parse_gains(const char* text, double gains[3]) {
+  return std::sscanf(text, "%lf,%lf,%lf", &gains[0], &gains[1],
+                     &gains[2]) == 3;
+}
+
+static bool parse_cartridge(const char* name, pros::v5::MotorGears& gears) {
+  if(std::strcmp(name, "red") == 0) {
+    gears = pros::v5::MotorGears::red;
+  } else if(std::strcmp(name, "green") == 0) {
+    gears = pros::v5::MotorGears::green;
+  } else if(std::strcmp(name, "blue") == 0) {
+    gears = pros::v5::MotorGears::blue;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  pros::v5::MotorGears cartridge = pros::v5::MotorGears::green;
+  double gear_ratio = 1.0;
+  double wheel_diameter = 4.0;
+  bool is_drive = false;
+  double distance_gains[3] = {600.0, 0.0, 40.0};
+  double heading_gains[3] = {300.0, 0.0, 20.0};
+  int tolerance = 0;
+  double tracker_ticks = 0.0;
+  double tracker_ratio = 1.0;
+  double tracker_wheel = 2.75;
+  int first_log = 1;
+  for(; first_log < argc && argv[first_log][0] == '-'; first_log++) {
+    const char* option = argv[first_log];
+    if(std::strcmp(option, "--drive") == 0) {
+      is_drive = true;
+      continue;
+    }
+    if(first_log + 1 >= argc) {
+      break;
+    }
+    const char* value = argv[++first_log];
+    if(std::strcmp(option, "--distance-pid") == 0 ||
+       std::strcmp(option, "--heading-pid") == 0) {
+      if(!parse_gains(value, option[2] == 'd' ? distance_gains
+                                              : heading_gains)) {
+        std::fprintf(stderr, "%s takes kP,kI,kD\n", option);
+        return 2;
+      }
+    } else if(std::strcmp(option, "--tolerance") == 0) {
+      tolerance = std::atoi(value);
+    } else if(std::strcmp(option, "--cartridge") == 0) {
+      if(!parse_cartridge(value, cartridge)) {
+        std::fprintf(stderr, "unknown cartridge %s\n", value);
+        return 2;
+      }
+    } else if(std::strcmp(option, "--ratio") == 0) {
+      gear_ratio = std::atof(value);
+    } else if(std::strcmp(option, "--wheel") == 0) {
+      wheel_diameter = std::atof(value);
+    } else if(std::strcmp(option, "--tracker") == 0) {
+      if(std::strcmp(value, "adi") == 0) {
+        tracker_ticks = util::ADI_ENCODER_TICK_PER_REVOLUTION;
+      } else if(std::strcmp(value, "rotation") == 0) {
+        tracker_ticks = util::ROTATION_SENSOR_TICK_PER_REVOLUTION;
+      } else {
+        std::fprintf(stderr, "unknown tracker %s\n", value);
+        return 2;
+      }
+    } else if(std::strcmp(option, "--tracker-ratio") == 0) {
+      tracker_ratio = std::atof(value);
+    } else if(std::strcmp(option, "--tracker-wheel") == 0) {
+      tracker_wheel = std::atof(value);
+    } else {
+      std::fprintf(stderr, "unknown option %s\n", option);
+      return 2;
+    }
+  }
+  if(first_log >= argc) {
+    std::fprintf(stderr,
+                 "usage: %s [--drive] [--cartridge red|green|blue] "
+                 "[--ratio R] [--wheel INCHES] [--tracker adi|rotation] "
+                 "[--tracker-ratio R] [--tracker-wheel INCHES] "
+                 "[--distance-pid P,I,D] [--heading-pid P,I,D] "
+                 "[--tolerance MV] LOG...\n",
+                 argv[0]);
+    return 2;
+  }
+
+  const DrivetrainGeometry geometry(cartridge, gear_ratio,
+                                    wheel_diameter * units::inch);
+  const DrivetrainGeometry tracker_geometry(tracker_ticks, tracker_ratio,
+                                            tracker_wheel * units::inch);
+  int result = 0;
+  for(int i = first_log; i < argc; i++) {
+    std::vector<Record> records;
+    if(!read_log_file(argv[i], records)) {
+      std::fprintf(stderr, "%s: not a readable apollo log\n", argv[i]);
+      result = 1;
+      continue;
+    }
+    OdometryReplay target(geometry,
+                          tracker_ticks > 0.0 ? &tracker_geometry : nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    const ReplayStats stats = replay(records, target);
+    const double elapsed = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    const double logged =
+        records.empty() ? 0.0
+                        : (records.back().header.timestamp -
+                           records.front().header.timestamp) /
+                              1e6;
+    std::printf(
+        "%s: %zu records, %zu poses, max pose error %.4f m, max heading "
+        "error %.4f rad, %.1fx real time\n",
+        argv[i], stats.record_count, stats.pose_count, stats.max_pose_error,
+        stats.max_heading_error, elapsed > 0.0 ? logged / elapsed : 0.0);
+    if(stats.gap_count > 0) {
+      std::printf("%s: %zu gaps, %lu records dropped on the brain; the pose "
+                  "was seeded again after each\n",
+                  argv[i], stats.gap_count,
+                  static_cast<unsigned long>(stats.dropped_count));
+    }
+    if(!is_drive) {
+      continue;
+    }
+    DriveReplay drive(geometry,
+                      DriveController(PIDController(distance_gains[0],
+                                                    distance_gains[1],
+                                                    distance_gains[2]),
+                                      PIDController(heading_gains[0],
+                                                    heading_gains[1],
+                                                    heading_gains[2])));
+    const ReplayStats drive_stats = replay(records, drive, tolerance);
+    std::printf("%s: %zu drive commands, %zu mismatched, max error %d mV",
+                argv[i], drive_stats.command_count,
+                drive_stats.mismatched_command_count,
+                drive_stats.max_command_error);
+    if(drive_stats.mismatched_command_count > 0) {
+      std::printf(", first at %lu us",
+                  static_cast<unsigned long>(
+                      drive_stats.first_mismatch_timestamp));
+      result = 1;
+    }
+    std::printf("\n");
+  }
+  return result;
+}
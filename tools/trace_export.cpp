@@ -0,0 +1,134 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/**
+ * Converts a file written by apollo::trace::dump() into Chrome Trace JSON,
+ * for chrome://tracing or ui.perfetto.dev.
+ *
+ *   trace_export apollo_trace.bin > trace.json
+ */
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "apollo/trace/traceFile.hpp"
+
+using namespace apollo::trace;
+
+static void print_json_string(std::FILE* output, const char* text) {
+  std::fputc('"', output);
+  for(; *text != '\0'; text++) {
+    const unsigned char c = static_cast<unsigned char>(*text);
+    if(c == '"' || c == '\\') {
+      std::fprintf(output, "\\%c", c);
+    } else if(c < 0x20) {
+      std::fprintf(output, "\\u%04x", c);
+    } else {
+      std::fputc(c, output);
+    }
+  }
+  std::fputc('"', output);
+}
+
+int main(int argc, char** argv) {
+  if(argc != 2) {
+    std::fprintf(stderr, "usage: %s TRACE_FILE > trace.json\n", argv[0]);
+    return 2;
+  }
+  std::FILE* input = std::fopen(argv[1], "rb");
+  if(input == nullptr) {
+    std::perror(argv[1]);
+    return 1;
+  }
+  TraceFileHeader header;
+  if(std::fread(&header, sizeof(header), 1, input) != 1 ||
+     std::memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+     header.version != TRACE_FILE_VERSION) {
+    std::fprintf(stderr, "%s: not an apollo trace\n", argv[1]);
+    std::fclose(input);
+    return 1;
+  }
+  std::vector<TraceFileName> tasks(header.task_count);
+  std::vector<TraceFileName> names(header.name_count);
+  std::vector<TraceFileEvent> events(header.event_count);
+  const bool complete =
+      std::fread(tasks.data(), sizeof(TraceFileName), tasks.size(), input) ==
+          tasks.size() &&
+      std::fread(names.data(), sizeof(TraceFileName), names.size(), input) ==
+          names.size() &&
+      std::fread(events.data(), sizeof(TraceFileEvent), events.size(),
+                 input) == events.size();
+  std::fclose(input);
+  if(!complete) {
+    std::fprintf(stderr, "%s: truncated trace\n", argv[1]);
+    return 1;
+  }
+  for(TraceFileName& name : tasks) {
+    name.name[TRACE_NAME_SIZE - 1] = '\0';
+  }
+  for(TraceFileName& name : names) {
+    name.name[TRACE_NAME_SIZE - 1] = '\0';
+  }
+
+  std::printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first = true;
+  for(std::size_t task = 0; task < tasks.size(); task++) {
+    std::printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":%zu,\"args\":{\"name\":",
+                first ? "" : ",\n", task + 1);
+    print_json_string(stdout, tasks[task].name);
+    std::printf("}}");
+    first = false;
+  }
+
+  // A task's buffer may start in the middle of a begin/end pair. Ends
+  // without a begin are skipped so the viewer does not mis-nest the rest.
+  std::vector<int> depth(tasks.size(), 0);
+  unsigned long skipped = 0;
+  for(const TraceFileEvent& event : events) {
+    const bool is_overflow = event.name == TRACE_OVERFLOW_NAME;
+    if(event.task >= tasks.size() ||
+       (!is_overflow && event.name >= names.size())) {
+      skipped++;
+      continue;
+    }
+    if(event.type == TRACE_BEGIN) {
+      depth[event.task]++;
+    } else if(event.type == TRACE_END) {
+      if(depth[event.task] == 0) {
+        skipped++;
+        continue;
+      }
+      depth[event.task]--;
+    } else if(event.type != TRACE_INSTANT) {
+      skipped++;
+      continue;
+    }
+    std::printf("%s{\"name\":", first ? "" : ",\n");
+    print_json_string(stdout, is_overflow ? "(name table full)"
+                                          : names[event.name].name);
+    std::printf(",\"ph\":\"%c\",\"ts\":%lu,\"pid\":1,\"tid\":%u%s}",
+                event.type, static_cast<unsigned long>(event.timestamp),
+                event.task + 1u, event.type == TRACE_INSTANT ? ",\"s\":\"t\"" : "");
+    first = false;
+  }
+  std::printf("\n]}\n");
+
+  if(header.dropped_count > 0) {
+    std::fprintf(stderr, "%lu events were dropped on the brain\n",
+                 static_cast<unsigned long>(header.dropped_count));
+  }
+  if(header.overflow_count > 0) {
+    std::fprintf(stderr,
+                 "%u events had more than %zu distinct names and are shown "
+                 "as (name table full)\n",
+                 header.overflow_count, TRACE_MAX_NAMES);
+  }
+  if(skipped > 0) {
+    std::fprintf(stderr, "%lu unmatched or invalid events skipped\n",
+                 skipped);
+  }
+  return 0;
+}